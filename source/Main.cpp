@@ -1,12 +1,21 @@
 #include <MainWindow.hpp>
+#include <OfflineRenderer.hpp>
 
 
-int main(int, char**){
-    if(!MainWindow::Initialize()){
+int main(int argc, char** argv){
+    if(OfflineRenderer::IsRequested(argc, argv)){
+        return OfflineRenderer::Run(argc, argv);
+    }
+    std::string audioDevice(AUDIO_DEVICE_DEFAULT);
+    for(int i = 1; i < argc; i++){
+        if((0 == std::strcmp(argv[i], "--audio-device")) && ((i + 1) < argc)){
+            audioDevice = argv[++i];
+        }
+    }
+    if(!MainWindow::Initialize(audioDevice)){
         return -1;
     }
     MainWindow::MainLoop();
     MainWindow::Terminate();
     return 0;
 }
-
@@ -6,9 +6,10 @@ GLFWwindow* MainWindow::glfwWindow = nullptr;
 Canvas MainWindow::canvas;
 GLuint MainWindow::rectVAO = 0;
 GLuint MainWindow::rectVBO = 0;
+bool MainWindow::redrawRequested = true;
 
 
-bool MainWindow::Initialize(void){
+bool MainWindow::Initialize(std::string audioDevice){
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     // Make sure that the window is terminated
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -17,12 +18,18 @@ bool MainWindow::Initialize(void){
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     // Initialize the audio engine
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-        if(!AudioEngine::Initialize()){
+        AudioDevice* device = AudioDevice::Create(audioDevice);
+        if(!device || !AudioEngine::Initialize(AUDIO_ENGINE_SAMPLE_RATE, device)){
             LogError("Could not initialize audio engine!\n");
             MainWindow::Terminate();
             return false;
         }
 
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    // Recover a recording that has been interrupted by a crash
+    // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+        Recorder::Recover();
+
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     // Initialize GLFW and set some window hints
     // For MAC OS X also call: glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
@@ -55,6 +62,7 @@ bool MainWindow::Initialize(void){
         }
         glfwMakeContextCurrent(glfwWindow);
         glfwSetFramebufferSizeCallback(glfwWindow, MainWindow::CallbackFramebufferSize);
+        glfwSetWindowRefreshCallback(glfwWindow, MainWindow::CallbackWindowRefresh);
         glfwSetDropCallback(glfwWindow, MainWindow::CallbackDrop);
         glfwSetKeyCallback(glfwWindow, MainWindow::CallbackKey);
         glfwSetCursorPosCallback(glfwWindow, MainWindow::CallbackCursorPosition);
@@ -129,14 +137,26 @@ void MainWindow::MainLoop(void){
     glfwMaximizeWindow(glfwWindow);
     glfwSetTime(0.0);
     double previousTime = 0.0;
+    bool wasAnimating = false;
+    redrawRequested = true;
     while(!glfwWindowShouldClose(glfwWindow)){
+        // Nothing moves: block until an event arrives (the timeout is used to re-check the animation state)
+        bool animating = canvas.IsAnimating();
+        if(!animating && !wasAnimating && !redrawRequested){
+            glfwWaitEventsTimeout(WINDOW_IDLE_TIMEOUT);
+            continue;
+        }
+        wasAnimating = animating;
+        redrawRequested = false;
+
         // Get elapsed time to last cycle
         double time = glfwGetTime();
         double dt = time - previousTime;
 
-        // Limit FPS
-        if(dt < 0.01){
-            std::this_thread::sleep_for(std::chrono::microseconds((int)((0.01 - dt)*1e6)));
+        // Limit FPS to the refresh rate of the monitor (in case the swap interval is not supported)
+        double minFrameTime = GetMinFrameTime();
+        if(animating && (dt < minFrameTime)){
+            std::this_thread::sleep_for(std::chrono::microseconds((int)((minFrameTime - dt)*1e6)));
             time = glfwGetTime();
             dt = time - previousTime;
         }
@@ -144,13 +164,27 @@ void MainWindow::MainLoop(void){
 
         // Rendering + swap buffers
         canvas.Render(glfwWindow, dt);
+        FrameProfiler::BeginStage(FRAME_STAGE_SWAP);
         glfwSwapBuffers(glfwWindow);
+        FrameProfiler::EndStage(FRAME_STAGE_SWAP);
+        FrameProfiler::EndFrame();
 
         // Poll all events
         glfwPollEvents();
     }
 }
 
+double MainWindow::GetMinFrameTime(void){
+    // Use the monitor of a fullscreen window, otherwise the primary monitor
+    GLFWmonitor* monitor = glfwGetWindowMonitor(glfwWindow);
+    if(!monitor){
+        monitor = glfwGetPrimaryMonitor();
+    }
+    const GLFWvidmode* mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+    int refreshRate = (mode && (mode->refreshRate > 0)) ? mode->refreshRate : WINDOW_DEFAULT_REFRESH;
+    return 1.0 / (double)refreshRate;
+}
+
 void MainWindow::DrawNormalizedRect(void){
     DEBUG_GLCHECK( glBindVertexArray(rectVAO); );
     DEBUG_GLCHECK( glDrawArrays(GL_TRIANGLE_STRIP, 0, 4); );
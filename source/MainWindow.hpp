@@ -3,6 +3,7 @@
 
 #include <Canvas.hpp>
 #include <Sequencer.hpp>
+#include <AudioDevice.hpp>
 
 
 class MainWindow {
@@ -11,9 +12,10 @@ class MainWindow {
 
         /**
          *  @brief Initialize the main window.
+         *  @param [in] audioDevice Name of the audio output device, see @ref AudioDevice::Create.
          *  @return True if success, false otherwise.
          */
-        static bool Initialize(void);
+        static bool Initialize(std::string audioDevice = AUDIO_DEVICE_DEFAULT);
 
         /**
          *  @brief Terminate the main window.
@@ -31,18 +33,26 @@ class MainWindow {
         static void DrawNormalizedRect(void);
 
     protected:
-        /* Window callbacks (are forwarded to the @ref canvas) */
-        static void CallbackFramebufferSize(GLFWwindow* wnd, int width, int height){ canvas.Resize(wnd, width, height); }
-        static void CallbackDrop(GLFWwindow* wnd, int count, const char** paths){ canvas.DropFiles(wnd, count, paths); }
-        static void CallbackKey(GLFWwindow* wnd, int key, int scancode, int action, int mods){ canvas.CallbackKey(wnd, key, scancode, action, mods); }
-        static void CallbackCursorPosition(GLFWwindow* wnd, double xpos, double ypos){ canvas.CallbackCursorPosition(wnd, xpos, ypos); }
-        static void CallbackMouseButton(GLFWwindow* wnd, int button, int action, int mods){ canvas.CallbackMouseButton(wnd, button, action, mods); }
-        static void CallbackChar(GLFWwindow* wnd, unsigned codepoint){ canvas.CallbackChar(wnd, codepoint); }
-        static void CallbackScroll(GLFWwindow* wnd, double xoffset, double yoffset){ canvas.CallbackScroll(wnd, xoffset, yoffset); }
+        /* Window callbacks (are forwarded to the @ref canvas and request a redraw) */
+        static void CallbackFramebufferSize(GLFWwindow* wnd, int width, int height){ canvas.Resize(wnd, width, height); redrawRequested = true; }
+        static void CallbackWindowRefresh(GLFWwindow* wnd){ (void)wnd; redrawRequested = true; }
+        static void CallbackDrop(GLFWwindow* wnd, int count, const char** paths){ canvas.DropFiles(wnd, count, paths); redrawRequested = true; }
+        static void CallbackKey(GLFWwindow* wnd, int key, int scancode, int action, int mods){ canvas.CallbackKey(wnd, key, scancode, action, mods); redrawRequested = true; }
+        static void CallbackCursorPosition(GLFWwindow* wnd, double xpos, double ypos){ canvas.CallbackCursorPosition(wnd, xpos, ypos); redrawRequested = true; }
+        static void CallbackMouseButton(GLFWwindow* wnd, int button, int action, int mods){ canvas.CallbackMouseButton(wnd, button, action, mods); redrawRequested = true; }
+        static void CallbackChar(GLFWwindow* wnd, unsigned codepoint){ canvas.CallbackChar(wnd, codepoint); redrawRequested = true; }
+        static void CallbackScroll(GLFWwindow* wnd, double xoffset, double yoffset){ canvas.CallbackScroll(wnd, xoffset, yoffset); redrawRequested = true; }
 
     private:
         static GLFWwindow* glfwWindow;    ///< The GLFW window or zero if not initialized.
         static GLuint rectVAO;            ///< VAO for normalized rectangle.
         static GLuint rectVBO;            ///< VBO for normalized rectangle.
+        static bool redrawRequested;      ///< True if an event requires the next frame to be rendered.
+
+        /**
+         *  @brief Get the minimum time between two frames during continuous rendering.
+         *  @return Frame period of the monitor that contains the window (or the primary monitor) in seconds.
+         */
+        static double GetMinFrameTime(void);
 };
 
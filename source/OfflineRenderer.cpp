@@ -0,0 +1,108 @@
+#include <OfflineRenderer.hpp>
+#include <AudioEngine.hpp>
+#include <Sequencer.hpp>
+#include <WaveFileWriter.hpp>
+
+
+bool OfflineRenderer::IsRequested(int argc, char** argv){
+    for(int i = 1; i < argc; i++){
+        if(0 == std::strcmp(argv[i], "--render")){
+            return true;
+        }
+    }
+    return false;
+}
+
+int OfflineRenderer::Run(int argc, char** argv){
+    std::string inputFile, outputFile;
+    double tempoScale = 1.0;
+    uint32_t sampleRate = AUDIO_ENGINE_SAMPLE_RATE;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        bool hasValue = ((i + 1) < argc);
+        if(("--render" == arg) && hasValue){
+            inputFile = argv[++i];
+        }
+        else if(("-o" == arg) && hasValue){
+            outputFile = argv[++i];
+        }
+        else if(("--tempo" == arg) && hasValue){
+            char* end = nullptr;
+            tempoScale = std::strtod(argv[++i], &end);
+            if(!end || *end || (tempoScale < SEQUENCER_TEMPO_SCALE_MIN) || (tempoScale > SEQUENCER_TEMPO_SCALE_MAX)){
+                LogError("Tempo scale \"%s\" must be in range [%g, %g]!\n", argv[i], SEQUENCER_TEMPO_SCALE_MIN, SEQUENCER_TEMPO_SCALE_MAX);
+                return -1;
+            }
+        }
+        else if(("--rate" == arg) && hasValue){
+            char* end = nullptr;
+            unsigned long rate = std::strtoul(argv[++i], &end, 10);
+            if(!end || *end || (rate < 8000) || (rate > 192000)){
+                LogError("Sample rate \"%s\" must be in range [8000, 192000]!\n", argv[i]);
+                return -1;
+            }
+            sampleRate = (uint32_t)rate;
+        }
+        else{
+            PrintUsage();
+            return -1;
+        }
+    }
+    if(inputFile.empty() || outputFile.empty()){
+        PrintUsage();
+        return -1;
+    }
+    return Render(inputFile, outputFile, tempoScale, sampleRate) ? 0 : -1;
+}
+
+bool OfflineRenderer::Render(std::string inputFile, std::string outputFile, double tempoScale, uint32_t sampleRate){
+    auto timeOfStart = std::chrono::steady_clock::now();
+
+    // The audio engine is only used for synthesis, no audio device is opened
+    if(!AudioEngine::Initialize(sampleRate, nullptr)){
+        LogError("Could not initialize audio engine!\n");
+        return false;
+    }
+    AudioEngine::SetStreamingMode(false);
+
+    // Read and render the MIDI file, all tracks are rendered in parallel
+    Sequencer sequencer;
+    if(!sequencer.ReadMIDIFile(inputFile)){
+        AudioEngine::Terminate();
+        return false;
+    }
+    sequencer.Generate(tempoScale, false);
+    std::vector<float> mixdown;
+    sequencer.Mix(mixdown);
+    sequencer.tracks.clear();
+    AudioEngine::Terminate();
+
+    // Write the mixdown to the wave file
+    if((uint64_t)(4 * mixdown.size()) > WAVE_FILE_WRITER_MAX_DATA_SIZE){
+        LogError("Rendered audio (%.1f s) exceeds the maximum size of a wave file!\n", (double)(mixdown.size() / 2) / (double)sampleRate);
+        return false;
+    }
+    WaveFileWriter writer;
+    if(!writer.Open(outputFile, sampleRate, 2)){
+        return false;
+    }
+    bool success = writer.Write(mixdown.data(), mixdown.size());
+    success &= writer.Close();
+    if(!success){
+        LogError("Could not write wave file \"%s\"!\n", outputFile.c_str());
+        return false;
+    }
+    double duration = (double)(mixdown.size() / 2) / (double)sampleRate;
+    double elapsed = 1e-9 * (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - timeOfStart).count();
+    LogMessage("Rendered %.1f s of audio to \"%s\" in %.1f s (%.1fx real time)\n", duration, outputFile.c_str(), elapsed, duration / std::max(elapsed, 1e-9));
+    return true;
+}
+
+void OfflineRenderer::PrintUsage(void){
+    LogMessage("Usage: CKeys --render input.mid -o output.wav [--tempo scale] [--rate samplerate]\n");
+    LogMessage("  --render input.mid  MIDI file to be rendered\n");
+    LogMessage("  -o output.wav       Wave file to be written (stereo, 32-bit float)\n");
+    LogMessage("  --tempo scale       Tempo scale in range [%g, %g], default: 1\n", SEQUENCER_TEMPO_SCALE_MIN, SEQUENCER_TEMPO_SCALE_MAX);
+    LogMessage("  --rate samplerate   Number of samples per second, default: %d\n", AUDIO_ENGINE_SAMPLE_RATE);
+}
+
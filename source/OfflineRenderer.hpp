@@ -0,0 +1,44 @@
+#pragma once
+
+
+/**
+ *  @brief Class: OfflineRenderer
+ *  @details Renders a MIDI file to a wave file without creating a window or opening an audio device.
+ *  Usage: CKeys --render input.mid -o output.wav [--tempo 1.2] [--rate 48000]
+ *  The sequence tracks are rendered in parallel on all hardware threads, so rendering is usually much faster than real time.
+ */
+class OfflineRenderer {
+    public:
+        /**
+         *  @brief Check whether the command line arguments request an offline rendering.
+         *  @param [in] argc Number of command line arguments.
+         *  @param [in] argv Command line arguments.
+         *  @return True if the argument "--render" is given, false otherwise.
+         */
+        static bool IsRequested(int argc, char** argv);
+
+        /**
+         *  @brief Parse the command line arguments and run the offline rendering.
+         *  @param [in] argc Number of command line arguments.
+         *  @param [in] argv Command line arguments.
+         *  @return Exit code of the application: zero if success, non-zero otherwise.
+         */
+        static int Run(int argc, char** argv);
+
+    private:
+        /**
+         *  @brief Render a MIDI file to a wave file.
+         *  @param [in] inputFile The filename of the MIDI file.
+         *  @param [in] outputFile The filename of the wave file to be written.
+         *  @param [in] tempoScale Scaling for tempo of the whole sequence in range [SEQUENCER_TEMPO_SCALE_MIN, SEQUENCER_TEMPO_SCALE_MAX].
+         *  @param [in] sampleRate Number of samples per second.
+         *  @return True if success, false otherwise.
+         */
+        static bool Render(std::string inputFile, std::string outputFile, double tempoScale, uint32_t sampleRate);
+
+        /**
+         *  @brief Print the usage of the offline rendering mode.
+         */
+        static void PrintUsage(void);
+};
+
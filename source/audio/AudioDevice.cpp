@@ -0,0 +1,21 @@
+#include <AudioDevice.hpp>
+#include <AudioDevicePortAudio.hpp>
+#include <AudioDeviceNull.hpp>
+#include <AudioDeviceFile.hpp>
+
+
+AudioDevice* AudioDevice::Create(std::string name){
+    if("portaudio" == name){
+        return new AudioDevicePortAudio();
+    }
+    if("null" == name){
+        return new AudioDeviceNull();
+    }
+    const std::string filePrefix("file:");
+    if((name.size() > filePrefix.size()) && (0 == name.compare(0, filePrefix.size(), filePrefix))){
+        return new AudioDeviceFile(name.substr(filePrefix.size()));
+    }
+    LogError("Unknown audio device \"%s\"!\n", name.c_str());
+    return nullptr;
+}
+
@@ -0,0 +1,82 @@
+#pragma once
+
+
+#define AUDIO_DEVICE_DEFAULT    "portaudio"   ///< Name of the default audio output device.
+
+
+/**
+ *  @brief Callback function of an audio output device.
+ *  @param [out] output Destination buffer for stereo interleaved samples.
+ *  @param [in] frameCount Number of stereo frames to be written.
+ *  @param [in] outputTime Time in seconds at which the first frame leaves the DAC, measured by the clock of @ref AudioDevice::GetTime.
+ *  @param [in] xrun True if the device detected a buffer underflow or overflow since the previous callback.
+ *  @return True if the stream should continue, false if the stream is completed.
+ */
+typedef bool (*AudioDeviceCallback)(float* output, uint32_t frameCount, double outputTime, bool xrun);
+
+
+/**
+ *  @brief Class: AudioDevice
+ *  @details Interface of an audio output device that periodically requests stereo float samples from a callback function.
+ *  The callback is invoked from a device thread. When the callback returns false, the device becomes inactive but @ref Stop must still be called.
+ */
+class AudioDevice {
+    public:
+        /**
+         *  @brief Delete the audio device.
+         */
+        virtual ~AudioDevice(){}
+
+        /**
+         *  @brief Open the audio device.
+         *  @param [in] sampleRate Number of samples per second.
+         *  @param [in] framesPerBuffer Number of stereo frames per callback.
+         *  @param [in] callback The callback function that provides the samples.
+         *  @return True if success, false otherwise.
+         */
+        virtual bool Open(uint32_t sampleRate, uint32_t framesPerBuffer, AudioDeviceCallback callback) = 0;
+
+        /**
+         *  @brief Stop and close the audio device.
+         */
+        virtual void Close(void) = 0;
+
+        /**
+         *  @brief Start calling the callback function.
+         *  @return True if success, false otherwise.
+         */
+        virtual bool Start(void) = 0;
+
+        /**
+         *  @brief Stop calling the callback function.
+         *  @return True if success, false otherwise.
+         *  @details Waits until the current callback has returned.
+         */
+        virtual bool Stop(void) = 0;
+
+        /**
+         *  @brief Check whether the device is active, that is, the device is started and the callback did not complete the stream.
+         *  @return True if active, false otherwise.
+         */
+        virtual bool IsActive(void) = 0;
+
+        /**
+         *  @brief Get the output latency of the device.
+         *  @return Time in seconds from a callback to the moment its first sample is audible.
+         */
+        virtual double GetOutputLatency(void) = 0;
+
+        /**
+         *  @brief Get the current time of the device clock.
+         *  @return Time in seconds, the same clock is used for the output time that is passed to the callback function.
+         */
+        virtual double GetTime(void) = 0;
+
+        /**
+         *  @brief Create an audio device by its name.
+         *  @param [in] name Either "portaudio" (default audio device), "null" (discards all samples) or "file:<filename>" (writes all samples to a wave file).
+         *  @return The audio device or nullptr if the name is unknown. The caller takes the ownership.
+         */
+        static AudioDevice* Create(std::string name);
+};
+
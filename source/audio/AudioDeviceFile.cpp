@@ -0,0 +1,33 @@
+#include <AudioDeviceFile.hpp>
+
+
+AudioDeviceFile::AudioDeviceFile(std::string filename): filename(filename){}
+
+AudioDeviceFile::~AudioDeviceFile(){
+    Close();
+}
+
+bool AudioDeviceFile::Open(uint32_t sampleRate, uint32_t framesPerBuffer, AudioDeviceCallback callback){
+    Close();
+    if(!AudioDeviceNull::Open(sampleRate, framesPerBuffer, callback)){
+        return false;
+    }
+    if(!writer.Open(filename, sampleRate, 2)){
+        AudioDeviceNull::Close();
+        return false;
+    }
+    return true;
+}
+
+void AudioDeviceFile::Close(void){
+    // Stop the clock thread before the file is completed
+    AudioDeviceNull::Close();
+    if(writer.IsOpen() && !writer.Close()){
+        LogError("Could not write wave file \"%s\"!\n", filename.c_str());
+    }
+}
+
+void AudioDeviceFile::Output(const float* samples, uint32_t num){
+    (void) writer.Write(samples, num);
+}
+
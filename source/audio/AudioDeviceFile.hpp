@@ -0,0 +1,36 @@
+#pragma once
+
+
+#include <AudioDeviceNull.hpp>
+#include <WaveFileWriter.hpp>
+
+
+/**
+ *  @brief Class: AudioDeviceFile
+ *  @details Behaves like the null audio device but writes the exact output of every callback to a wave file.
+ *  The output of consecutive streams is appended, the file is completed when the device is closed.
+ */
+class AudioDeviceFile: public AudioDeviceNull {
+    public:
+        /**
+         *  @brief Create a file audio device.
+         *  @param [in] filename The filename of the wave file to be written when the device is opened.
+         */
+        explicit AudioDeviceFile(std::string filename);
+
+        /**
+         *  @brief Close the file audio device.
+         */
+        ~AudioDeviceFile();
+
+        bool Open(uint32_t sampleRate, uint32_t framesPerBuffer, AudioDeviceCallback callback)override;
+        void Close(void)override;
+
+    protected:
+        void Output(const float* samples, uint32_t num)override;
+
+    private:
+        std::string filename;     ///< The filename of the wave file.
+        WaveFileWriter writer;    ///< Writes the samples to the wave file.
+};
+
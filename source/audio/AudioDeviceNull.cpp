@@ -0,0 +1,92 @@
+#include <AudioDeviceNull.hpp>
+
+
+AudioDeviceNull::AudioDeviceNull(): running(false), active(false){
+    sampleRate = 0;
+    framesPerBuffer = 0;
+    callback = nullptr;
+}
+
+AudioDeviceNull::~AudioDeviceNull(){
+    // Only the clock thread is stopped here, resources of derived classes are released by their own destructors
+    (void) AudioDeviceNull::Stop();
+}
+
+bool AudioDeviceNull::Open(uint32_t sampleRate, uint32_t framesPerBuffer, AudioDeviceCallback callback){
+    Close();
+    if(!sampleRate || !framesPerBuffer || !callback){
+        return false;
+    }
+    this->sampleRate = sampleRate;
+    this->framesPerBuffer = framesPerBuffer;
+    this->callback = callback;
+    return true;
+}
+
+void AudioDeviceNull::Close(void){
+    (void) Stop();
+    callback = nullptr;
+}
+
+bool AudioDeviceNull::Start(void){
+    if(!callback){
+        return false;
+    }
+    (void) Stop();
+    running = true;
+    active = true;
+    clock = std::thread(&AudioDeviceNull::Run, this);
+    return true;
+}
+
+bool AudioDeviceNull::Stop(void){
+    running = false;
+    if(clock.joinable()){
+        clock.join();
+    }
+    active = false;
+    return true;
+}
+
+bool AudioDeviceNull::IsActive(void){
+    return active;
+}
+
+double AudioDeviceNull::GetOutputLatency(void){
+    return 0.0;
+}
+
+double AudioDeviceNull::GetTime(void){
+    return 1e-9 * (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void AudioDeviceNull::Output(const float* samples, uint32_t num){
+    (void)samples;
+    (void)num;
+}
+
+void AudioDeviceNull::Run(void){
+    // The deadline of each buffer is advanced by one buffer period, so the clock does not drift
+    const auto period = std::chrono::nanoseconds((int64_t)framesPerBuffer * 1000000000 / (int64_t)sampleRate);
+    std::vector<float> buffer(2 * framesPerBuffer, 0.0f);
+    auto deadline = std::chrono::steady_clock::now();
+    while(running){
+        // A callback that starts later than one buffer period after its deadline would have caused an underflow of a real device, the clock is resynchronized in that case
+        auto now = std::chrono::steady_clock::now();
+        bool xrun = (now > (deadline + period));
+        if(xrun){
+            deadline = now;
+        }
+        // Samples are "played" at their deadline
+        double outputTime = 1e-9 * (double)std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        bool proceed = callback(&buffer[0], framesPerBuffer, outputTime, xrun);
+        Output(&buffer[0], (uint32_t)buffer.size());
+        if(!proceed){
+            break;
+        }
+        deadline += period;
+        std::this_thread::sleep_until(deadline);
+    }
+    active = false;
+}
+
@@ -0,0 +1,54 @@
+#pragma once
+
+
+#include <AudioDevice.hpp>
+
+
+/**
+ *  @brief Class: AudioDeviceNull
+ *  @details Calls the callback function from a thread that is clocked by a steady timer and discards all samples.
+ *  Derived classes can consume the samples by overriding @ref Output.
+ */
+class AudioDeviceNull: public AudioDevice {
+    public:
+        /**
+         *  @brief Create a null audio device.
+         */
+        AudioDeviceNull();
+
+        /**
+         *  @brief Close the null audio device.
+         */
+        ~AudioDeviceNull();
+
+        bool Open(uint32_t sampleRate, uint32_t framesPerBuffer, AudioDeviceCallback callback)override;
+        void Close(void)override;
+        bool Start(void)override;
+        bool Stop(void)override;
+        bool IsActive(void)override;
+        double GetOutputLatency(void)override;
+        double GetTime(void)override;
+
+    protected:
+        uint32_t sampleRate;            ///< Number of samples per second.
+
+        /**
+         *  @brief Consume the samples of one callback (device thread only).
+         *  @param [in] samples Stereo interleaved samples.
+         *  @param [in] num Number of floats.
+         */
+        virtual void Output(const float* samples, uint32_t num);
+
+    private:
+        uint32_t framesPerBuffer;       ///< Number of stereo frames per callback.
+        AudioDeviceCallback callback;   ///< The callback function that provides the samples.
+        std::thread clock;              ///< Thread that calls the callback function once per buffer period.
+        std::atomic<bool> running;      ///< True while the clock thread should run.
+        std::atomic<bool> active;       ///< True while the clock thread calls the callback function.
+
+        /**
+         *  @brief Clock thread function.
+         */
+        void Run(void);
+};
+
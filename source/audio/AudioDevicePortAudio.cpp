@@ -0,0 +1,85 @@
+#include <AudioDevicePortAudio.hpp>
+
+
+AudioDevicePortAudio::AudioDevicePortAudio(){
+    audioStream = nullptr;
+    portAudioInitialized = false;
+    callback = nullptr;
+    outputLatency = 0.0;
+}
+
+AudioDevicePortAudio::~AudioDevicePortAudio(){
+    Close();
+}
+
+bool AudioDevicePortAudio::Open(uint32_t sampleRate, uint32_t framesPerBuffer, AudioDeviceCallback callback){
+    Close();
+    PaError err = Pa_Initialize();
+    if(err != paNoError){
+        LogError("Coult not initialize PortAudio!\n");
+        return false;
+    }
+    portAudioInitialized = true;
+    this->callback = callback;
+    int numInputChannels = 0;
+    int numOutputChannels = 2;
+    err = Pa_OpenDefaultStream(&audioStream, numInputChannels, numOutputChannels, paFloat32, (double)sampleRate, (unsigned long)framesPerBuffer, AudioDevicePortAudio::CallbackAudioStream, this);
+    if(err != paNoError){
+        LogError("Could not open default audio stream!\n");
+        audioStream = nullptr;
+        Close();
+        return false;
+    }
+    const PaStreamInfo* info = Pa_GetStreamInfo(audioStream);
+    outputLatency = info ? info->outputLatency : 0.0;
+    return true;
+}
+
+void AudioDevicePortAudio::Close(void){
+    if(audioStream){
+        (void) Pa_StopStream(audioStream);
+        (void) Pa_CloseStream(audioStream);
+        audioStream = nullptr;
+    }
+    if(portAudioInitialized){
+        Pa_Terminate();
+        portAudioInitialized = false;
+    }
+    callback = nullptr;
+    outputLatency = 0.0;
+}
+
+bool AudioDevicePortAudio::Start(void){
+    return audioStream && (paNoError == Pa_StartStream(audioStream));
+}
+
+bool AudioDevicePortAudio::Stop(void){
+    return audioStream && (paNoError == Pa_StopStream(audioStream));
+}
+
+bool AudioDevicePortAudio::IsActive(void){
+    return audioStream && (1 == Pa_IsStreamActive(audioStream));
+}
+
+double AudioDevicePortAudio::GetOutputLatency(void){
+    return outputLatency;
+}
+
+double AudioDevicePortAudio::GetTime(void){
+    return audioStream ? (double)Pa_GetStreamTime(audioStream) : 0.0;
+}
+
+int AudioDevicePortAudio::CallbackAudioStream(const void *input, void *output, unsigned long frameCount, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void *userData){
+    AudioDevicePortAudio* device = (AudioDevicePortAudio*)userData;
+    bool xrun = (0 != (statusFlags & (paOutputUnderflow | paOutputOverflow)));
+
+    // Some host APIs do not provide the DAC time, it is estimated from the stream time and the output latency in that case
+    double outputTime = timeInfo ? timeInfo->outputBufferDacTime : 0.0;
+    if(outputTime <= 0.0){
+        outputTime = (double)Pa_GetStreamTime(device->audioStream) + device->outputLatency;
+    }
+    bool proceed = device->callback((float*)output, (uint32_t)frameCount, outputTime, xrun);
+    (void)input;
+    return proceed ? paContinue : paComplete;
+}
+
@@ -0,0 +1,40 @@
+#pragma once
+
+
+#include <AudioDevice.hpp>
+#include <portaudio.h>
+
+
+/**
+ *  @brief Class: AudioDevicePortAudio
+ *  @details Plays the samples on the default audio output device of PortAudio.
+ */
+class AudioDevicePortAudio: public AudioDevice {
+    public:
+        /**
+         *  @brief Create a PortAudio device.
+         */
+        AudioDevicePortAudio();
+
+        /**
+         *  @brief Close the PortAudio device.
+         */
+        ~AudioDevicePortAudio();
+
+        bool Open(uint32_t sampleRate, uint32_t framesPerBuffer, AudioDeviceCallback callback)override;
+        void Close(void)override;
+        bool Start(void)override;
+        bool Stop(void)override;
+        bool IsActive(void)override;
+        double GetOutputLatency(void)override;
+        double GetTime(void)override;
+
+    private:
+        PaStream* audioStream;          ///< Audio stream object (set by @ref Open).
+        bool portAudioInitialized;      ///< True if PortAudio has been initialized by @ref Open.
+        AudioDeviceCallback callback;   ///< The callback function that provides the samples.
+        double outputLatency;           ///< Output latency of the audio stream in seconds (set by @ref Open).
+
+        static int CallbackAudioStream(const void *input, void *output, unsigned long frameCount, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void *userData);
+};
+
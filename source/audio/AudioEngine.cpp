@@ -1,6 +1,7 @@
 #include <AudioEngine.hpp>
 #include <MainWindow.hpp>
 #include <Sequencer.hpp>
+#include <AudioMixer.hpp>
 
 
 // Github allows file sizes to be at most 100 MB, so sound font is splited into two parts
@@ -11,14 +12,23 @@ RESOURCE_EXTLD(source_thirdparty_TinySoundFont_soundfont_part2_bin);
 
 bool AudioEngine::initialized = false;
 tsf* AudioEngine::soundFont = nullptr;
-PaStream* AudioEngine::audioStream = nullptr;
-std::chrono::time_point<std::chrono::steady_clock> AudioEngine::timeOfStart;
-double AudioEngine::outputLatency = 0.0;
+uint32_t AudioEngine::sampleRate = AUDIO_ENGINE_SAMPLE_RATE;
+AudioDevice* AudioEngine::device = nullptr;
+bool AudioEngine::streamingMode = true;
+AudioStreamer AudioEngine::streamer;
+NoteRenderCache AudioEngine::noteCache(AUDIO_ENGINE_NOTE_CACHE_CAPACITY);
+std::atomic<RenderSnapshot*> AudioEngine::snapshot(nullptr);
+std::atomic<uint32_t> AudioEngine::currentSample(0);
+std::atomic<uint64_t> AudioEngine::callbackEpoch(0);
+std::atomic<uint32_t> AudioEngine::callbackDuration(0);
+std::atomic<uint32_t> AudioEngine::numXRuns(0);
+std::vector<std::pair<RenderSnapshot*, uint64_t>> AudioEngine::retiredSnapshots;
+SeqLock<AudioEngine::ClockPoint> AudioEngine::audioClock;
 double AudioEngine::timePointer = 0.0;
 double AudioEngine::timePointerOfStart = 0.0;
 
 
-bool AudioEngine::Initialize(void){
+bool AudioEngine::Initialize(uint32_t sampleRate, AudioDevice* device){
     // Make sure that the engine is terminated
     Terminate();
 
@@ -36,45 +46,40 @@ bool AudioEngine::Initialize(void){
     std::copy(&data2[0], &data2[0] + len2, data.begin() + len1);
     soundFont = tsf_load_memory(&data[0], (int)data.size());
     if(!soundFont){
+        delete device;
         Terminate();
         return false;
     }
-    tsf_set_output(soundFont, TSF_STEREO_INTERLEAVED, AUDIO_ENGINE_SAMPLE_RATE);
-
-    // Setup port audio
-    PaError err = Pa_Initialize();
-    if(err != paNoError){
-        LogError("Coult not initialize PortAudio!\n");
-        Terminate();
-        return false;
+    AudioEngine::sampleRate = sampleRate;
+    tsf_set_output(soundFont, TSF_STEREO_INTERLEAVED, (int)sampleRate);
+    timePointer = 0.0;
+    timePointerOfStart = 0.0;
+    if(!device){
+        return (initialized = true);
     }
-    int numInputChannels = 0;
-    int numOutputChannels = 2;
-    void *userData = nullptr;
-    err = Pa_OpenDefaultStream(&audioStream, numInputChannels, numOutputChannels, paFloat32, AUDIO_ENGINE_SAMPLE_RATE, AUDIO_ENGINE_SAMPLE_BUFFER_SIZE, AudioEngine::CallbackAudioStream, userData);
-    if(err != paNoError){
-        LogError("Could not open default audio stream!\n");
+
+    // Open the audio output device
+    if(!device->Open(sampleRate, AUDIO_ENGINE_SAMPLE_BUFFER_SIZE, AudioEngine::CallbackAudioDevice)){
+        LogError("Could not open audio device!\n");
+        delete device;
         Terminate();
         return false;
     }
-    timeOfStart = std::chrono::steady_clock::now();
-    outputLatency = 0.0;
-    timePointer = 0.0;
-    timePointerOfStart = 0.0;
+    AudioEngine::device = device;
     return (initialized = true);
 }
 
 void AudioEngine::Terminate(void){
-    if(audioStream){
-        (void) Pa_StopStream(audioStream);
-        (void) Pa_CloseStream(audioStream);
-        audioStream = nullptr;
+    if(device){
+        device->Close();
+        delete device;
+        device = nullptr;
     }
-    timeOfStart = std::chrono::steady_clock::now();
-    outputLatency = 0.0;
+    streamer.Stop();
+    ReclaimSnapshots(true);
+    noteCache.Clear();
     timePointer = 0.0;
     timePointerOfStart = 0.0;
-    Pa_Terminate();
     if(soundFont){
         tsf_close(soundFont);
         soundFont = nullptr;
@@ -82,13 +87,86 @@ void AudioEngine::Terminate(void){
     initialized = false;
 }
 
+uint32_t AudioEngine::GetSampleRate(void){
+    return sampleRate;
+}
+
 void AudioEngine::RenderSound(SequenceTrack& track){
     // Remove current samples
     track.samples.clear();
     if(!initialized)
         return;
 
-    // Get maximum number of samples required to render the complete track
+    // Render with an independent synthesizer that shares the sound font data
+    tsf* synthesizer = tsf_copy(soundFont);
+    if(!synthesizer)
+        return;
+    RenderSound(track, synthesizer);
+    tsf_close(synthesizer);
+
+    // Cached notes only pay off within one render pass, do not keep them alive afterwards
+    noteCache.Release();
+}
+
+void AudioEngine::RenderSound(std::vector<SequenceTrack>& tracks, uint32_t numThreads){
+    // Remove current samples
+    for(auto&& track : tracks){
+        track.samples.clear();
+    }
+    if(!initialized || tracks.empty())
+        return;
+
+    // Each track gets its own synthesizer (voice/channel state), all of them share the read-only sound font data.
+    // The copies are created here because tsf_copy() is not thread-safe.
+    std::vector<tsf*> synthesizers(tracks.size(), nullptr);
+    for(size_t i = 0; i < tracks.size(); i++){
+        synthesizers[i] = tsf_copy(soundFont);
+    }
+
+    // Hand out the most expensive tracks first to keep all workers busy until the end
+    std::vector<double> cost(tracks.size(), 0.0);
+    for(size_t i = 0; i < tracks.size(); i++){
+        for(int k = 0; k < 88; k++){
+            for(auto&& note : tracks[i].lanes[k]){
+                cost[i] += note.sustainOff - note.on + AUDIO_ENGINE_RELEASE_TIME_NOTE_OFF;
+            }
+        }
+    }
+    std::vector<size_t> order(tracks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&cost](size_t a, size_t b){ return cost[a] > cost[b]; });
+
+    // Idle workers take the next pending track until all tracks are rendered
+    if(!numThreads){
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = std::min(numThreads, (uint32_t)tracks.size());
+    std::atomic<size_t> next(0);
+    auto worker = [&](){
+        for(size_t n = next++; n < order.size(); n = next++){
+            size_t i = order[n];
+            if(synthesizers[i]){
+                RenderSound(tracks[i], synthesizers[i]);
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for(uint32_t t = 1; t < numThreads; t++){
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for(auto&& w : workers){
+        w.join();
+    }
+    for(auto&& synthesizer : synthesizers){
+        tsf_close(synthesizer);
+    }
+
+    // Cached notes only pay off within one render pass, do not keep them alive afterwards
+    noteCache.Release();
+}
+
+uint32_t AudioEngine::GetRequiredNumSamples(const SequenceTrack& track){
     double maxTime = -1.0;
     for(int i = 0; i < 88; i++){
         for(auto&& note : track.lanes[i]){
@@ -96,79 +174,190 @@ void AudioEngine::RenderSound(SequenceTrack& track){
         }
     }
     if(maxTime <= 0.0)
-        return;
+        return 0;
+    return 2 * std::min((uint32_t)((maxTime + AUDIO_ENGINE_RELEASE_TIME_NOTE_OFF) * (double)sampleRate), GetMaxNumFrames());
+}
 
-    const double sampleRate = (double)AUDIO_ENGINE_SAMPLE_RATE;
-    maxTime = std::clamp(maxTime + AUDIO_ENGINE_RELEASE_TIME_NOTE_OFF, 0.0, std::min(4294967295.0 / sampleRate, 21600.0)); // 6 hours at 22050 stereo are about 4 GB RAM !
-    uint32_t maxNumSamples = (uint32_t)(maxTime * sampleRate);
+uint32_t AudioEngine::GetMaxNumFrames(void){
+    return (uint32_t)(std::min(2147483647.0 / (double)sampleRate, AUDIO_ENGINE_MAX_DURATION) * (double)sampleRate);
+}
+
+void AudioEngine::SetStreamingMode(bool enable){
+    if(StreamIsPlaying()) return;
+    streamingMode = enable;
+}
+
+bool AudioEngine::GetStreamingMode(void){
+    return streamingMode;
+}
+
+void AudioEngine::RenderSound(SequenceTrack& track, tsf* synthesizer){
+    // Get the number of samples of the complete track assuming the nominal release time, the actual length depends on the release tails
+    uint32_t numSamples = GetRequiredNumSamples(track);
+    if(!numSamples)
+        return;
+    const double sampleRate = (double)AudioEngine::sampleRate;
+    const size_t maxNumSamples = 2 * (size_t)GetMaxNumFrames();
 
     // Check if instrument of track is supported by the sound font
     int instrument = (int)track.instrumentType;
-    if(instrument >= tsf_get_presetcount(soundFont)){
+    if(instrument >= tsf_get_presetcount(synthesizer)){
         return;
     }
 
-    // Render audio samples for all note blocks
-    tsf_reset(soundFont);
+    // Render audio samples for all note blocks, notes with equal parameters are rendered once and then taken from the note render cache
     int channel = (int)track.channel;
-    tsf_channel_set_presetnumber(soundFont, channel, instrument, (AUDIO_ENGINE_MIDI_CHANNEL_DRUMS == channel) ? 1 : 0);
-    std::vector<float> buffer(maxNumSamples * 2, 0.0f);
+    tsf_channel_set_presetnumber(synthesizer, channel, instrument, (AUDIO_ENGINE_MIDI_CHANNEL_DRUMS == channel) ? 1 : 0);
+    NoteRenderCache::Key cacheKey;
+    cacheKey.presetIndex = (int32_t)tsf_channel_get_preset_index(synthesizer, channel);
+    cacheKey.numReleaseFrames = (uint32_t)std::lround(AUDIO_ENGINE_RELEASE_TIME_MAX * sampleRate);
+    std::vector<float> buffer;
+    buffer.reserve(numSamples);
+    size_t maxIdxOff = 0;
     for(int key = 0; key < 88; key++){
+        cacheKey.key = (uint8_t)(key + 21);
         for(auto&& note : track.lanes[key]){
-            uint32_t idxOn = (uint32_t)(note.on * sampleRate);
-            uint32_t idxOff = (uint32_t)(note.sustainOff * sampleRate);
-            uint32_t idxReleased = (uint32_t)((note.sustainOff + AUDIO_ENGINE_RELEASE_TIME_NOTE_OFF) * sampleRate);
-            tsf_channel_note_on(soundFont, channel, key + 21, (float)note.velocity);
-            tsf_render_float(soundFont, &buffer[2*idxOn], idxOff - idxOn, 1);
-            tsf_channel_note_off(soundFont, channel, key + 21);
-            tsf_render_float(soundFont, &buffer[2*idxOff], idxReleased - idxOff, 1);
+            size_t idxOn = 2 * (size_t)(note.on * sampleRate);
+            if(idxOn >= maxNumSamples){
+                continue;
+            }
+            maxIdxOff = std::max(maxIdxOff, 2 * (size_t)(note.sustainOff * sampleRate));
+            cacheKey.velocity = (uint8_t)std::clamp(std::lround(note.velocity * 127.0), 1L, 127L);
+            cacheKey.numSustainFrames = (uint32_t)std::lround(std::max(0.0, note.sustainOff - note.on) * sampleRate);
+            NoteRenderCache::Waveform waveform = noteCache.Find(cacheKey);
+            if(!waveform){
+                waveform = RenderNote(synthesizer, channel, cacheKey);
+                noteCache.Insert(cacheKey, waveform);
+            }
+            size_t idxEnd = std::min(idxOn + waveform->size(), maxNumSamples);
+            if(idxEnd > buffer.size()){
+                buffer.resize(idxEnd, 0.0f);
+            }
+            AudioMixer::MixAdd(&buffer[idxOn], waveform->data(), 1.0f, idxEnd - idxOn);
         }
     }
+
+    // The track lasts at least until the last note off event, even if all voices ended before
+    buffer.resize(std::max(buffer.size(), std::min(maxIdxOff, maxNumSamples)), 0.0f);
     track.samples.swap(buffer);
 }
 
+NoteRenderCache::Waveform AudioEngine::RenderNote(tsf* synthesizer, int channel, const NoteRenderCache::Key& note){
+    std::vector<float> samples;
+    samples.reserve(2 * ((size_t)note.numSustainFrames + (size_t)AUDIO_ENGINE_SAMPLE_BUFFER_SIZE));
+    bool audible = false;
+    auto renderBlock = [&](uint32_t numFrames){
+        size_t offset = samples.size();
+        samples.resize(offset + 2 * (size_t)numFrames);
+        tsf_render_float(synthesizer, samples.data() + offset, (int)numFrames, 0);
+        float peak = 0.0f;
+        for(size_t k = offset; k < samples.size(); k++){
+            peak = std::max(peak, std::fabs(samples[k]));
+        }
+        audible |= (peak >= AUDIO_ENGINE_RELEASE_SILENCE);
+        return peak;
+    };
+
+    // Sustain segment, one-shot voices (e.g. percussion) may end before the note off event
+    tsf_channel_note_on(synthesizer, channel, (int)note.key, (float)note.velocity / 127.0f);
+    for(uint32_t n = 0; (n < note.numSustainFrames) && tsf_active_voice_count(synthesizer); n += AUDIO_ENGINE_SAMPLE_BUFFER_SIZE){
+        (void) renderBlock(std::min((uint32_t)AUDIO_ENGINE_SAMPLE_BUFFER_SIZE, note.numSustainFrames - n));
+    }
+
+    // Release segment, stops as soon as all voices have ended or the tail became silent after the note has been audible
+    tsf_channel_note_off(synthesizer, channel, (int)note.key);
+    for(uint32_t n = 0; (n < note.numReleaseFrames) && tsf_active_voice_count(synthesizer); n += AUDIO_ENGINE_SAMPLE_BUFFER_SIZE){
+        float peak = renderBlock(std::min((uint32_t)AUDIO_ENGINE_SAMPLE_BUFFER_SIZE, note.numReleaseFrames - n));
+        if(audible && (peak < AUDIO_ENGINE_RELEASE_SILENCE)){
+            break;
+        }
+    }
+    tsf_channel_sounds_off_all(synthesizer, channel);
+    samples.shrink_to_fit();
+    return std::make_shared<const std::vector<float>>(std::move(samples));
+}
+
+void AudioEngine::PublishSnapshot(std::vector<float>&& mixdown, uint32_t numSamples){
+    RenderSnapshot* previous = snapshot.exchange(new RenderSnapshot(std::move(mixdown), numSamples));
+    if(previous){
+        retiredSnapshots.push_back(std::make_pair(previous, callbackEpoch.load()));
+    }
+    ReclaimSnapshots(false);
+}
+
+void AudioEngine::ReleaseSnapshot(void){
+    if(StreamIsPlaying()){
+        return;
+    }
+    RenderSnapshot* previous = snapshot.exchange(nullptr);
+    if(previous){
+        retiredSnapshots.push_back(std::make_pair(previous, callbackEpoch.load()));
+    }
+    ReclaimSnapshots(false);
+}
+
+void AudioEngine::ReclaimSnapshots(bool force){
+    // A snapshot can still be accessed only if it has been replaced while the callback was running (odd epoch) and that callback has not yet returned
+    uint64_t epoch = callbackEpoch.load();
+    auto isSafe = [force, epoch](const std::pair<RenderSnapshot*, uint64_t>& retired){
+        return force || !(retired.second & 1) || (retired.second != epoch);
+    };
+    for(auto&& retired : retiredSnapshots){
+        if(isSafe(retired)){
+            delete retired.first;
+            retired.first = nullptr;
+        }
+    }
+    retiredSnapshots.erase(std::remove_if(retiredSnapshots.begin(), retiredSnapshots.end(), [](const std::pair<RenderSnapshot*, uint64_t>& retired){ return !retired.first; }), retiredSnapshots.end());
+    if(force){
+        delete snapshot.exchange(nullptr);
+    }
+}
+
 bool AudioEngine::StartStream(void){
-    // Error if not initialized or sequencer has no samples
-    if(!initialized) return false;
-    if(!MainWindow::canvas.scene.performance.sequencer.maxNumSamples) return false;
+    // Error if not initialized, there is no audio device or there are no samples to be played
+    if(!initialized || !device) return false;
+    const RenderSnapshot* s = snapshot.load();
+    if(!s || !s->numSamples) return false;
 
-    // Remember time pointer of start and get output latency
+    // Remember time pointer of start, the audio clock becomes valid with the first callback
     timePointerOfStart = timePointer;
-    const PaStreamInfo* info = Pa_GetStreamInfo(audioStream);
-    if(info){
-        outputLatency = info->outputLatency;
-    }
 
     // Set index from where to start playing
-    MainWindow::canvas.scene.performance.sequencer.currentSample = timePointerOfStart * (double)(2 * AUDIO_ENGINE_SAMPLE_RATE);
-    if(MainWindow::canvas.scene.performance.sequencer.currentSample >= MainWindow::canvas.scene.performance.sequencer.maxNumSamples){
-        MainWindow::canvas.scene.performance.sequencer.currentSample = !MainWindow::canvas.scene.performance.sequencer.maxNumSamples ? 0 : (MainWindow::canvas.scene.performance.sequencer.maxNumSamples - 1);
+    uint32_t startSample = (uint32_t)(timePointerOfStart * (double)(2 * sampleRate));
+    startSample = std::min(startSample, s->numSamples - 1);
+    currentSample.store(startSample);
+    audioClock.Store({startSample, 0.0, false});
+
+    // Start the streaming synthesizer ahead of the playback position
+    if(streamingMode && !streamer.Start(soundFont, MainWindow::canvas.scene.performance.sequencer.tracks, startSample, s->numSamples)){
+        LogError("Could not start streaming synthesizer!\n");
+        return false;
     }
 
-    // Start streaming and remember system time
-    bool result = (paNoError == Pa_StartStream(audioStream));
-    timeOfStart = std::chrono::steady_clock::now();
-    return result;
+    // Start streaming
+    return device->Start();
 }
 
 bool AudioEngine::StopStream(void){
-    // Error if not initialized
-    if(!initialized) return false;
+    // Error if not initialized or there is no audio device
+    if(!initialized || !device) return false;
 
-    // Time difference from start to now
+    // Keep the time pointer of the sample that is currently audible
     if(StreamIsPlaying()){
-        auto timeNow = std::chrono::steady_clock::now();
-        double deltaTimeToStart = std::max(0.0, 1e-9 * double(std::chrono::duration_cast<std::chrono::nanoseconds>(timeNow - timeOfStart).count()) - outputLatency);
-        timePointer = timePointerOfStart + deltaTimeToStart;
+        timePointer = ExtrapolateTimePointer();
     }
 
-    // Stop the stream (function waits until the stream is stopped completely)
-    return (paNoError == Pa_StopStream(audioStream));
+    // Stop the stream (function waits until the stream is stopped completely) and the streaming synthesizer
+    bool result = device->Stop();
+    streamer.Stop();
+    ReclaimSnapshots(false);
+    return result;
 }
 
 bool AudioEngine::StreamIsPlaying(void){
-    if(!initialized) return false;
-    return (1 == Pa_IsStreamActive(audioStream));
+    if(!initialized || !device) return false;
+    return device->IsActive();
 }
 
 double AudioEngine::GetTimePointer(void){
@@ -176,45 +365,90 @@ double AudioEngine::GetTimePointer(void){
     if(!initialized) return 0.0;
 
     // If stream is not active return current time pointer
-    if(!Pa_IsStreamActive(audioStream)) return timePointer;
-
-    // Time difference from start to now
-    auto timeNow = std::chrono::steady_clock::now();
-    double deltaTimeToStart = std::max(0.0, 1e-9 * double(std::chrono::duration_cast<std::chrono::nanoseconds>(timeNow - timeOfStart).count()) - outputLatency);
+    if(!StreamIsPlaying()) return timePointer;
 
     // Update time pointer and return
-    timePointer = timePointerOfStart + deltaTimeToStart;
+    timePointer = ExtrapolateTimePointer();
     return timePointer;
 }
 
+double AudioEngine::ExtrapolateTimePointer(void){
+    // The sample of the latest clock point leaves the DAC at its output time, the time pointer advances with the device clock from there
+    ClockPoint point = audioClock.Load();
+    if(!point.valid){
+        return timePointerOfStart;
+    }
+    double t = (double)(point.sample / 2) / (double)sampleRate + (device->GetTime() - point.outputTime);
+
+    // The DAC time is subject to jitter, the time pointer must not move backwards
+    return std::max(t, std::max(timePointer, timePointerOfStart));
+}
+
 void AudioEngine::SetTimePointer(double timePointer){
     if(StreamIsPlaying()) return;
-    double maxTimePointer = (double)(MainWindow::canvas.scene.performance.sequencer.maxNumSamples / 2) / (double)(AUDIO_ENGINE_SAMPLE_RATE);
+    double maxTimePointer = (double)(MainWindow::canvas.scene.performance.sequencer.maxNumSamples / 2) / (double)(sampleRate);
     AudioEngine::timePointer = std::clamp(timePointer, 0.0, maxTimePointer);
 }
 
-int AudioEngine::CallbackAudioStream(const void *input, void *output, unsigned long frameCount, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void *userData){
+void AudioEngine::GetCallbackStatistics(double& duration, uint32_t& numXRuns){
+    duration = 1e-9 * (double)AudioEngine::callbackDuration.load(std::memory_order_relaxed);
+    numXRuns = AudioEngine::numXRuns.load(std::memory_order_relaxed);
+}
+
+void AudioEngine::GetNoteCacheStatistics(double& hitRate, size_t& numBytes){
+    noteCache.GetStatistics(hitRate, numBytes);
+}
+
+bool AudioEngine::CallbackAudioDevice(float* output, uint32_t frameCount, double outputTime, bool xrun){
+    auto timeOfEntry = std::chrono::steady_clock::now();
+
+    // Enter the callback epoch, the snapshot obtained below remains valid until the epoch is left
+    callbackEpoch.fetch_add(1);
+    const RenderSnapshot* s = snapshot.load();
+    uint32_t numSamples = s ? s->numSamples : 0;
+    uint32_t idx = currentSample.load(std::memory_order_relaxed);
     uint32_t num = 2 * (uint32_t)frameCount;
-    float *out = (float*)output;
-    for(uint32_t k = 0, idx = MainWindow::canvas.scene.performance.sequencer.currentSample; k < num; k++, idx++){
-        out[k] = 0.0f;
-        for(auto&& track : MainWindow::canvas.scene.performance.sequencer.tracks){
-            if(track.samples.size() && (idx < track.samples.size())){
-                out[k] += track.samples[idx];
-            }
+    uint32_t numPlayed = num;
+    float *out = output;
+    if(streamingMode){
+        // A partially filled block before the end of the sequence means that the streamer could not keep up. The missing samples
+        // are played late, so only the samples that have been read are played in this block.
+        numPlayed = streamer.Read(out, num);
+        xrun |= (numPlayed < num) && ((idx + numPlayed) < numSamples);
+    }
+    else{
+        // Tracks are pre-mixed, copy the block after clamping the range once
+        uint32_t n = (s && (idx < (uint32_t)s->mixdown.size())) ? std::min(num, (uint32_t)s->mixdown.size() - idx) : 0;
+        if(n){
+            std::memcpy(out, &s->mixdown[idx], n * sizeof(float));
         }
+        std::fill(out + n, out + num, 0.0f);
+    }
+
+    // Publish the sample that is actually heard: after an underrun the next sample to be played leaves the DAC not before the next block,
+    // the time pointer holds until the audio catches up instead of running ahead of it
+    if(numPlayed < num){
+        audioClock.Store({idx + numPlayed, outputTime + (double)frameCount / (double)sampleRate, true});
+    }
+    else{
+        audioClock.Store({idx, outputTime, true});
     }
 
     // Check if stream is completed
-    MainWindow::canvas.scene.performance.sequencer.currentSample += num;
-    if(MainWindow::canvas.scene.performance.sequencer.currentSample >= MainWindow::canvas.scene.performance.sequencer.maxNumSamples){
-        MainWindow::canvas.scene.performance.sequencer.currentSample = !MainWindow::canvas.scene.performance.sequencer.maxNumSamples ? 0 : (MainWindow::canvas.scene.performance.sequencer.maxNumSamples - 1);
-        return paComplete;
-    }
-    (void)input;
-    (void)timeInfo;
-    (void)statusFlags;
-    (void)userData;
-    return paContinue;
+    bool result = true;
+    idx += numPlayed;
+    if(idx >= numSamples){
+        idx = !numSamples ? 0 : (numSamples - 1);
+        result = false;
+    }
+    currentSample.store(idx, std::memory_order_relaxed);
+    callbackEpoch.fetch_add(1);
+
+    // Statistics
+    if(xrun){
+        numXRuns.fetch_add(1, std::memory_order_relaxed);
+    }
+    callbackDuration.store((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - timeOfEntry).count(), std::memory_order_relaxed);
+    return result;
 }
 
@@ -1,36 +1,104 @@
 #pragma once
 
 
-#define AUDIO_ENGINE_SAMPLE_RATE             (22050) ///< Number of samples per second.
+#define AUDIO_ENGINE_SAMPLE_RATE             (22050) ///< Default number of samples per second.
 #define AUDIO_ENGINE_SAMPLE_BUFFER_SIZE      (256)   ///< Number of samples for audio buffer.
-#define AUDIO_ENGINE_RELEASE_TIME_NOTE_OFF   (2.0)   ///< Release time in seconds after a note off event.
+#define AUDIO_ENGINE_RELEASE_TIME_NOTE_OFF   (2.0)   ///< Nominal release time in seconds after a note off event (used to estimate the length of a sequence).
+#define AUDIO_ENGINE_RELEASE_TIME_MAX        (10.0)  ///< Maximum release time in seconds after a note off event, release tails of presets with a long release are extended up to this time.
+#define AUDIO_ENGINE_RELEASE_SILENCE         (1.5849e-5f) ///< Absolute sample value (-96 dB) below which a release tail is considered silent.
+#define AUDIO_ENGINE_MAX_DURATION            (21600.0) ///< Maximum duration of a rendered sequence track in seconds (6 hours at 22050 stereo are about 4 GB RAM).
 #define AUDIO_ENGINE_MIDI_CHANNEL_DRUMS      (9)     ///< MIDI channel that indicates drums/percussions.
+#define AUDIO_ENGINE_STREAMING_LOOKAHEAD     (0.3)   ///< Time in seconds the streaming synthesizer renders ahead of the playback position.
+#define AUDIO_ENGINE_STREAMING_PREFILL       (4)     ///< Number of audio buffers that are synthesized before the stream is started.
+#define AUDIO_ENGINE_NOTE_CACHE_CAPACITY     (256 * 1024 * 1024) ///< Maximum number of bytes of all rendered notes that are kept in the note render cache during one render pass.
 
 
 #include <SequenceTrack.hpp>
+#include <AudioStreamer.hpp>
+#include <RenderSnapshot.hpp>
+#include <SeqLock.hpp>
+#include <NoteRenderCache.hpp>
+#include <AudioDevice.hpp>
 #include <tsf.h>
-#include <portaudio.h>
 
 
 class AudioEngine {
     public:
         /**
          *  @brief Initialize the audio engine.
+         *  @param [in] sampleRate Number of samples per second.
+         *  @param [in] device The audio output device to be opened or nullptr for offline rendering only. The audio engine takes the ownership.
          *  @return True if success, false otherwise.
+         *  @details Without an audio device, sequence tracks can be rendered by @ref RenderSound but nothing can be played.
          */
-        static bool Initialize(void);
+        static bool Initialize(uint32_t sampleRate, AudioDevice* device);
 
         /**
          *  @brief Terminate the audio engine.
          */
         static void Terminate(void);
 
+        /**
+         *  @brief Get the sample rate that has been set during initialization.
+         *  @return Number of samples per second.
+         */
+        static uint32_t GetSampleRate(void);
+
         /**
          *  @brief Render the sound of a sequence track.
          *  @param [in] track The sequence track for which to render the sound.
+         *  @details Rendered notes are cached during the call only, see @ref AUDIO_ENGINE_NOTE_CACHE_CAPACITY.
          */
         static void RenderSound(SequenceTrack& track);
 
+        /**
+         *  @brief Render the sound of multiple sequence tracks in parallel.
+         *  @param [in] tracks The sequence tracks for which to render the sound.
+         *  @param [in] numThreads Number of worker threads, defaults to 0 (number of hardware threads).
+         *  @details The result is bit-identical to calling @ref RenderSound for each track. Rendered notes are shared between all tracks
+         *  of this call and released when it returns, see @ref AUDIO_ENGINE_NOTE_CACHE_CAPACITY.
+         */
+        static void RenderSound(std::vector<SequenceTrack>& tracks, uint32_t numThreads = 0);
+
+        /**
+         *  @brief Get the number of samples that are required to render the complete sound of a sequence track.
+         *  @param [in] track The sequence track.
+         *  @return Length of the stereo sample buffer (number of all floats) or zero if the track contains no notes.
+         *  @details The length is based on the nominal release time @ref AUDIO_ENGINE_RELEASE_TIME_NOTE_OFF. Rendered tracks may be shorter or longer, depending on the actual release tails.
+         */
+        static uint32_t GetRequiredNumSamples(const SequenceTrack& track);
+
+        /**
+         *  @brief Enable or disable the streaming mode.
+         *  @param [in] enable True if sequence tracks should be synthesized in real-time during playback, false if the complete sound should be pre-rendered by @ref RenderSound.
+         *  @details The mode must not be changed while the stream is playing. A sequencer has to be re-generated after changing the mode.
+         */
+        static void SetStreamingMode(bool enable);
+
+        /**
+         *  @brief Check whether the streaming mode is enabled.
+         *  @return True if streaming mode is enabled, false otherwise.
+         */
+        static bool GetStreamingMode(void);
+
+        /**
+         *  @brief Publish new audio data of a sequence to the audio thread.
+         *  @param [in] mixdown Pre-mixed samples of all tracks (empty in streaming mode), the content is moved.
+         *  @param [in] numSamples Length of the stereo sample buffer of the whole sequence (number of all floats).
+         *  @details The data is handed over as an immutable render snapshot via an atomic pointer swap. Previous snapshots are
+         *  deleted as soon as the audio callback can no longer access them. This function never blocks the audio callback.
+         *  While the stream is playing, the previous snapshot stays alive until the current callback has returned, so two mixdowns
+         *  may coexist for a short time. Call @ref ReleaseSnapshot before generating a new mixdown to avoid this while the stream is stopped.
+         */
+        static void PublishSnapshot(std::vector<float>&& mixdown, uint32_t numSamples);
+
+        /**
+         *  @brief Delete the current render snapshot if the stream is not playing.
+         *  @details The mixdown of the snapshot is only read by the audio callback. Releasing it before a new mixdown is generated
+         *  lowers the peak memory by the size of one mixdown. Nothing can be played until the next snapshot is published.
+         */
+        static void ReleaseSnapshot(void);
+
         /**
          *  @brief Start the audio stream.
          *  @return True if success, false otherwise.
@@ -50,8 +118,9 @@ class AudioEngine {
         static bool StreamIsPlaying(void);
 
         /**
-         *  @brief Get the current time pointer (output latency corrected).
+         *  @brief Get the current time pointer, that is, the time of the sample that currently leaves the DAC.
          *  @return Time pointer in seconds.
+         *  @details While the stream is playing, the time pointer is extrapolated from the latest sample index and DAC time that has been published by the audio callback.
          */
         static double GetTimePointer(void);
 
@@ -62,17 +131,87 @@ class AudioEngine {
          */
         static void SetTimePointer(double timePointer);
 
+        /**
+         *  @brief Get statistics of the audio callback.
+         *  @param [out] duration Duration of the latest audio callback in seconds.
+         *  @param [out] numXRuns Number of buffer underflows and overflows since the audio engine has been initialized.
+         */
+        static void GetCallbackStatistics(double& duration, uint32_t& numXRuns);
+
+        /**
+         *  @brief Get statistics of the note render cache that is used by @ref RenderSound.
+         *  @param [out] hitRate Ratio of notes taken from the cache to all rendered notes.
+         *  @param [out] numBytes Memory used by the cached notes in bytes, zero unless a render pass is running.
+         */
+        static void GetNoteCacheStatistics(double& hitRate, size_t& numBytes);
+
     private:
+        class ClockPoint {
+            public:
+                uint32_t sample;       ///< Index to the stereo sample buffer of the first sample of an audio callback (of the next callback after an underrun).
+                double outputTime;     ///< Device time in seconds at which that sample leaves the DAC.
+                bool valid;            ///< False until the first audio callback after the stream has been started.
+        };
+
         static bool initialized;       ///< True if audio engine is initialized, false otherwise.
         static tsf* soundFont;         ///< Sound font object (set during initialization).
-        static PaStream* audioStream;  ///< Audio stream object (set during initialization).
+        static uint32_t sampleRate;    ///< Number of samples per second (set during initialization).
+        static AudioDevice* device;    ///< Audio output device (set during initialization, nullptr for offline rendering).
+        static bool streamingMode;     ///< True if sequence tracks are synthesized in real-time during playback.
+        static AudioStreamer streamer; ///< The streaming synthesizer (used in streaming mode only).
+        static NoteRenderCache noteCache; ///< Rendered notes that are reused within one call to @ref RenderSound, released at the end of each call.
+
+        /* Data that is shared with the audio thread */
+        static std::atomic<RenderSnapshot*> snapshot;                                   ///< The latest published render snapshot.
+        static std::atomic<uint32_t> currentSample;                                     ///< The current index to the stereo sample buffer of the playing sequence.
+        static std::atomic<uint64_t> callbackEpoch;                                     ///< Incremented when entering and leaving the audio callback (odd while the callback is running).
+        static std::vector<std::pair<RenderSnapshot*, uint64_t>> retiredSnapshots;     ///< Replaced snapshots and the callback epoch at the time they were replaced (accessed by the UI thread only).
+        static std::atomic<uint32_t> callbackDuration;                                  ///< Duration of the latest audio callback in nanoseconds.
+        static std::atomic<uint32_t> numXRuns;                                          ///< Number of buffer underflows and overflows (including streaming underruns).
+        static SeqLock<ClockPoint> audioClock;                                          ///< Latest sample index and its DAC time, published by the audio callback.
 
         /* Timing properties */
-        static std::chrono::time_point<std::chrono::steady_clock> timeOfStart;     ///< Time when the stream was started.
-        static double outputLatency;      ///< Output latency in seconds. The value is obtained when the stream is started.
         static double timePointer;        ///< Time pointer to the current point of the song (zero indicates start of song).
         static double timePointerOfStart; ///< Time pointer value when stream was started.
 
-        static int CallbackAudioStream(const void *input, void *output, unsigned long frameCount, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void *userData);
+        /**
+         *  @brief Render the sound of a sequence track using a specific synthesizer.
+         *  @param [in] track The sequence track for which to render the sound.
+         *  @param [in] synthesizer A synthesizer with a reset voice and channel state.
+         */
+        static void RenderSound(SequenceTrack& track, tsf* synthesizer);
+
+        /**
+         *  @brief Extrapolate the time pointer from the latest clock point of the audio callback.
+         *  @return Time pointer in seconds, never less than the time pointer of the last call.
+         */
+        static double ExtrapolateTimePointer(void);
+
+        /**
+         *  @brief Get the maximum number of frames of a rendered sequence track.
+         *  @return Maximum number of frames with respect to @ref AUDIO_ENGINE_MAX_DURATION and the 32-bit length of the stereo sample buffer.
+         */
+        static uint32_t GetMaxNumFrames(void);
+
+        /**
+         *  @brief Render a single note from a silent synthesizer.
+         *  @param [in] synthesizer A synthesizer whose channel is set to the preset of the note. All voices of the channel are stopped afterwards.
+         *  @param [in] channel The synthesizer channel.
+         *  @param [in] note The note parameters.
+         *  @return The stereo interleaved samples of the sustain and release segment of the note.
+         *  @details The note is rendered block-wise. Rendering stops as soon as all voices have ended or the release tail drops below @ref AUDIO_ENGINE_RELEASE_SILENCE.
+         */
+        static NoteRenderCache::Waveform RenderNote(tsf* synthesizer, int channel, const NoteRenderCache::Key& note);
+
+        /**
+         *  @brief Delete retired snapshots that can no longer be accessed by the audio callback.
+         *  @param [in] force True if all retired snapshots should be deleted (the audio stream must be closed).
+         */
+        static void ReclaimSnapshots(bool force);
+
+        /**
+         *  @brief Callback function of the audio device, see @ref AudioDeviceCallback.
+         */
+        static bool CallbackAudioDevice(float* output, uint32_t frameCount, double outputTime, bool xrun);
 };
 
@@ -0,0 +1,62 @@
+#include <AudioMixer.hpp>
+#if defined(__AVX__) || defined(__SSE__)
+#include <immintrin.h>
+#endif
+
+
+float AudioMixer::GetTrackGain(const std::vector<SequenceTrack>& tracks, size_t index){
+    bool anySolo = std::any_of(tracks.begin(), tracks.end(), [](const SequenceTrack& track){ return track.solo; });
+    const SequenceTrack& track = tracks[index];
+    if(track.mute || (anySolo && !track.solo)){
+        return 0.0f;
+    }
+    return std::max(0.0f, track.gain);
+}
+
+void AudioMixer::Mix(std::vector<float>& mixdown, const std::vector<SequenceTrack>& tracks, uint32_t numSamples){
+    mixdown.assign(numSamples, 0.0f);
+
+    // Only tracks that contain samples and are audible contribute to the mix
+    std::vector<std::pair<const std::vector<float>*, float>> sources;
+    for(size_t i = 0; i < tracks.size(); i++){
+        float gain = GetTrackGain(tracks, i);
+        if(tracks[i].samples.size() && (gain > 0.0f)){
+            sources.push_back(std::make_pair(&tracks[i].samples, gain));
+        }
+    }
+
+    // Mix block-wise, ranges are clamped once per block and track
+    for(size_t k = 0; k < (size_t)numSamples; k += AUDIO_MIXER_BLOCK_SIZE){
+        size_t blockEnd = std::min((size_t)numSamples, k + (size_t)AUDIO_MIXER_BLOCK_SIZE);
+        for(auto&& source : sources){
+            size_t end = std::min(blockEnd, source.first->size());
+            if(end > k){
+                MixAdd(&mixdown[k], source.first->data() + k, source.second, end - k);
+            }
+        }
+    }
+}
+
+void AudioMixer::MixAdd(float* dst, const float* src, float gain, size_t num){
+    size_t k = 0;
+    #if defined(__AVX__)
+    const __m256 g8 = _mm256_set1_ps(gain);
+    for(; (k + 8) <= num; k += 8){
+        __m256 d = _mm256_loadu_ps(dst + k);
+        __m256 s = _mm256_loadu_ps(src + k);
+        _mm256_storeu_ps(dst + k, _mm256_add_ps(d, _mm256_mul_ps(s, g8)));
+    }
+    #endif
+    #if defined(__SSE__)
+    const __m128 g4 = _mm_set1_ps(gain);
+    for(; (k + 4) <= num; k += 4){
+        __m128 d = _mm_loadu_ps(dst + k);
+        __m128 s = _mm_loadu_ps(src + k);
+        _mm_storeu_ps(dst + k, _mm_add_ps(d, _mm_mul_ps(s, g4)));
+    }
+    #endif
+    for(; k < num; k++){
+        dst[k] += gain * src[k];
+    }
+}
+
@@ -0,0 +1,39 @@
+#pragma once
+
+
+#define AUDIO_MIXER_BLOCK_SIZE   (4096) ///< Number of floats that are mixed per block (the destination block stays in the cache while all tracks are added).
+
+
+#include <SequenceTrack.hpp>
+
+
+class AudioMixer {
+    public:
+        /**
+         *  @brief Get the effective gain of a sequence track with respect to the gain, mute and solo settings of all tracks.
+         *  @param [in] tracks All sequence tracks.
+         *  @param [in] index Index of the track for which to get the gain.
+         *  @return The linear gain of the track, zero if the track is muted or another track is soloed.
+         */
+        static float GetTrackGain(const std::vector<SequenceTrack>& tracks, size_t index);
+
+        /**
+         *  @brief Mix the samples of all sequence tracks into a single stereo buffer.
+         *  @param [out] mixdown The output buffer, is resized to numSamples.
+         *  @param [in] tracks The sequence tracks whose samples are to be mixed.
+         *  @param [in] numSamples Length of the stereo output buffer (number of all floats).
+         *  @details Gain, mute and solo settings of the tracks are applied in the same pass.
+         */
+        static void Mix(std::vector<float>& mixdown, const std::vector<SequenceTrack>& tracks, uint32_t numSamples);
+
+        /**
+         *  @brief Add scaled samples to a destination buffer (dst += gain * src).
+         *  @param [inout] dst The destination buffer.
+         *  @param [in] src The source buffer.
+         *  @param [in] gain The gain to be applied to the source samples.
+         *  @param [in] num Number of floats to be processed.
+         *  @details Uses AVX or SSE instructions if enabled for the target, a scalar loop otherwise.
+         */
+        static void MixAdd(float* dst, const float* src, float gain, size_t num);
+};
+
@@ -0,0 +1,179 @@
+#include <AudioStreamer.hpp>
+#include <AudioEngine.hpp>
+#include <AudioMixer.hpp>
+
+
+/**
+ *  @brief Compare lane cursors or note off events for the min-heaps of the audio streamer.
+ *  @return True if a is processed after b: ordered by frame, events of the same frame by channel and key.
+ */
+template <class T> static bool IsLater(const T& a, const T& b){
+    return (a.frame > b.frame) || ((a.frame == b.frame) && ((a.channel > b.channel) || ((a.channel == b.channel) && (a.key > b.key))));
+}
+
+
+AudioStreamer::AudioStreamer(){
+    synthesizer = nullptr;
+    tracks = nullptr;
+    startFrame = 0;
+    frame = 0;
+    endFrame = 0;
+    running = false;
+}
+
+AudioStreamer::~AudioStreamer(){
+    Stop();
+}
+
+bool AudioStreamer::Start(tsf* soundFont, const std::vector<SequenceTrack>& tracks, uint32_t startSample, uint32_t numSamples){
+    // Make sure that the streamer is stopped
+    Stop();
+    if(!soundFont){
+        return false;
+    }
+    synthesizer = tsf_copy(soundFont);
+    if(!synthesizer){
+        return false;
+    }
+    startFrame = frame = startSample / 2;
+    endFrame = numSamples / 2;
+
+    // Setup one synthesizer channel per track and one cursor per lane, the lanes are already sorted by note on time, so the producer
+    // merges them on the fly instead of collecting and sorting all note events of the rest of the sequence here
+    this->tracks = &tracks;
+    cursors.reserve(88 * tracks.size());
+    noteOffs.reserve(88 * tracks.size());
+    batch.reserve(88 * tracks.size());
+    for(uint16_t t = 0; t < (uint16_t)tracks.size(); t++){
+        int instrument = (int)tracks[t].instrumentType;
+        float gain = AudioMixer::GetTrackGain(tracks, t);
+        if((instrument >= tsf_get_presetcount(synthesizer)) || (gain <= 0.0f)){
+            continue;
+        }
+        tsf_channel_set_presetnumber(synthesizer, t, instrument, (AUDIO_ENGINE_MIDI_CHANNEL_DRUMS == tracks[t].channel) ? 1 : 0);
+        tsf_channel_set_volume(synthesizer, t, gain);
+        for(uint8_t key = 0; key < 88; key++){
+            PushCursor({0, t, key, 0});
+        }
+    }
+
+    // Prefill some blocks and start the producer thread
+    const double sampleRate = (double)AudioEngine::GetSampleRate();
+    ringBuffer.Resize((size_t)(2.0 * AUDIO_ENGINE_STREAMING_LOOKAHEAD * sampleRate));
+    block.resize(2 * AUDIO_ENGINE_SAMPLE_BUFFER_SIZE);
+    for(int i = 0; i < AUDIO_ENGINE_STREAMING_PREFILL; i++){
+        (void) RenderBlock();
+    }
+    running = true;
+    producer = std::thread(&AudioStreamer::Produce, this);
+    return true;
+}
+
+void AudioStreamer::Stop(void){
+    running = false;
+    if(producer.joinable()){
+        producer.join();
+    }
+    if(synthesizer){
+        tsf_close(synthesizer);
+        synthesizer = nullptr;
+    }
+    cursors.clear();
+    noteOffs.clear();
+    batch.clear();
+    tracks = nullptr;
+    startFrame = 0;
+    frame = 0;
+    endFrame = 0;
+    ringBuffer.Clear();
+}
+
+uint32_t AudioStreamer::Read(float* output, uint32_t num){
+    uint32_t numRead = (uint32_t)ringBuffer.Read(output, num);
+    std::fill(output + numRead, output + num, 0.0f);
+    return numRead;
+}
+
+void AudioStreamer::PushCursor(LaneCursor cursor){
+    // Notes that end before the start frame are skipped, notes that are on at the start frame start there
+    const double sampleRate = (double)AudioEngine::GetSampleRate();
+    const std::vector<NoteBlock>& lane = (*tracks)[cursor.channel].lanes[cursor.key];
+    while((cursor.index < lane.size()) && ((uint32_t)(lane[cursor.index].sustainOff * sampleRate) <= startFrame)){
+        cursor.index++;
+    }
+    if(cursor.index < lane.size()){
+        cursor.frame = std::max((uint32_t)(lane[cursor.index].on * sampleRate), startFrame);
+        cursors.push_back(cursor);
+        std::push_heap(cursors.begin(), cursors.end(), IsLater<LaneCursor>);
+    }
+}
+
+uint32_t AudioStreamer::ProcessEvents(uint32_t f){
+    const double sampleRate = (double)AudioEngine::GetSampleRate();
+    for(;;){
+        uint32_t frameOff = noteOffs.empty() ? 0xFFFFFFFF : noteOffs.front().frame;
+        uint32_t frameOn = cursors.empty() ? 0xFFFFFFFF : cursors.front().frame;
+        if((frameOff > f) && (frameOn > f)){
+            return std::min(frameOff, frameOn);
+        }
+
+        // Note off events are processed before note on events of the same frame
+        if(frameOff <= frameOn){
+            std::pop_heap(noteOffs.begin(), noteOffs.end(), IsLater<NoteOff>);
+            tsf_channel_note_off(synthesizer, noteOffs.back().channel, noteOffs.back().key + 21);
+            noteOffs.pop_back();
+            continue;
+        }
+
+        // All notes of this frame are taken at once and their note off events are queued first, so that even the note off events of
+        // notes that start and end in this frame are processed before the note on events
+        batch.clear();
+        while(!cursors.empty() && (cursors.front().frame == frameOn)){
+            std::pop_heap(cursors.begin(), cursors.end(), IsLater<LaneCursor>);
+            LaneCursor cursor = cursors.back();
+            cursors.pop_back();
+            batch.push_back(cursor);
+            const NoteBlock& note = (*tracks)[cursor.channel].lanes[cursor.key][cursor.index];
+            noteOffs.push_back({(uint32_t)(note.sustainOff * sampleRate), cursor.channel, cursor.key});
+            std::push_heap(noteOffs.begin(), noteOffs.end(), IsLater<NoteOff>);
+            cursor.index++;
+            PushCursor(cursor);
+        }
+        while(!noteOffs.empty() && (noteOffs.front().frame <= frameOn)){
+            std::pop_heap(noteOffs.begin(), noteOffs.end(), IsLater<NoteOff>);
+            tsf_channel_note_off(synthesizer, noteOffs.back().channel, noteOffs.back().key + 21);
+            noteOffs.pop_back();
+        }
+        for(auto&& cursor : batch){
+            const NoteBlock& note = (*tracks)[cursor.channel].lanes[cursor.key][cursor.index];
+            tsf_channel_note_on(synthesizer, cursor.channel, cursor.key + 21, (float)note.velocity);
+        }
+    }
+}
+
+bool AudioStreamer::RenderBlock(void){
+    // Nothing to do if end of sequence is reached or ring buffer is full
+    if(frame >= endFrame) return false;
+    if(ringBuffer.GetNumWritable() < block.size()) return false;
+    uint32_t numFrames = std::min((uint32_t)(block.size() / 2), endFrame - frame);
+
+    // Render the block, split it at note events to keep them sample-accurate
+    uint32_t k = 0;
+    while(k < numFrames){
+        uint32_t next = ProcessEvents(frame + k);
+        uint32_t n = std::min(numFrames - k, next - (frame + k));
+        tsf_render_float(synthesizer, &block[2*k], (int)n, 0);
+        k += n;
+    }
+    frame += numFrames;
+    (void) ringBuffer.Write(&block[0], 2 * numFrames);
+    return true;
+}
+
+void AudioStreamer::Produce(void){
+    while(running && (frame < endFrame)){
+        if(!RenderBlock()){
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+
+#include <SequenceTrack.hpp>
+#include <RingBuffer.hpp>
+#include <tsf.h>
+
+
+class AudioStreamer {
+    public:
+        /**
+         *  @brief Create an audio streamer.
+         */
+        AudioStreamer();
+
+        /**
+         *  @brief Delete the audio streamer.
+         */
+        ~AudioStreamer();
+
+        /**
+         *  @brief Start the producer thread that synthesizes the sequence tracks ahead of the playback position.
+         *  @param [in] soundFont The sound font to be used. A linked copy is created, the original object is not modified.
+         *  @param [in] tracks Sequence tracks to be synthesized. The tracks must not be changed until @ref Stop is called, their note
+         *  lanes are merged incrementally by the producer thread.
+         *  @param [in] startSample Index to the stereo sample buffer from where to start synthesizing.
+         *  @param [in] numSamples Total number of stereo samples (number of all floats) of the whole sequence.
+         *  @return True if success, false otherwise.
+         *  @details The ring buffer is prefilled with a few blocks before the producer thread is started.
+         */
+        bool Start(tsf* soundFont, const std::vector<SequenceTrack>& tracks, uint32_t startSample, uint32_t numSamples);
+
+        /**
+         *  @brief Stop the producer thread and release the synthesizer.
+         */
+        void Stop(void);
+
+        /**
+         *  @brief Read samples from the stream (audio thread only).
+         *  @param [out] output Destination buffer for stereo interleaved samples.
+         *  @param [in] num Number of floats to be read.
+         *  @return Number of floats that have been read. The remaining floats of the output buffer are set to zero.
+         */
+        uint32_t Read(float* output, uint32_t num);
+
+    private:
+        class LaneCursor {
+            public:
+                uint32_t frame;     ///< Frame index of the note on event of the current note.
+                uint16_t channel;   ///< Synthesizer channel (index of sequence track).
+                uint8_t key;        ///< Lane index in range [0, 87].
+                size_t index;       ///< Index of the current note of the lane.
+        };
+
+        class NoteOff {
+            public:
+                uint32_t frame;     ///< Frame index at which the note is off.
+                uint16_t channel;   ///< Synthesizer channel (index of sequence track).
+                uint8_t key;        ///< Lane index in range [0, 87].
+        };
+
+        tsf* synthesizer;                         ///< Linked copy of the sound font that holds the voice state of the stream.
+        const std::vector<SequenceTrack>* tracks; ///< The sequence tracks to be synthesized.
+        std::vector<LaneCursor> cursors;          ///< Min-heap of the next note of all lanes, ordered by frame, channel and key.
+        std::vector<NoteOff> noteOffs;            ///< Min-heap of the note off events of all notes that are on, ordered by frame, channel and key.
+        std::vector<LaneCursor> batch;            ///< Notes whose note on events are processed in the current frame.
+        uint32_t startFrame;                      ///< Index of the frame from where synthesizing has been started.
+        uint32_t frame;                           ///< Index of the next frame to be synthesized.
+        uint32_t endFrame;                        ///< Number of frames of the whole sequence.
+        std::vector<float> block;                 ///< Temporary buffer for one synthesized block.
+        RingBuffer<float> ringBuffer;             ///< Synthesized samples that are waiting to be played.
+        std::thread producer;                     ///< Producer thread.
+        std::atomic<bool> running;                ///< True while the producer thread should run.
+
+        /**
+         *  @brief Move a lane cursor to the next note that ends after the start frame and insert it into the heap of cursors.
+         *  @param [in] cursor The lane cursor, its index refers to the first note to be checked.
+         */
+        void PushCursor(LaneCursor cursor);
+
+        /**
+         *  @brief Process all note events up to a frame in order of their frames, note off events before note on events of the same frame.
+         *  @param [in] f Frame index up to which (including) note events are processed.
+         *  @return Frame index of the next note event that has not been processed, 0xFFFFFFFF if there is none.
+         */
+        uint32_t ProcessEvents(uint32_t f);
+
+        /**
+         *  @brief Synthesize the next block and write it to the ring buffer.
+         *  @return True if a block has been written, false if the ring buffer is full or the end of the sequence has been reached.
+         */
+        bool RenderBlock(void);
+
+        /**
+         *  @brief Producer thread function.
+         */
+        void Produce(void);
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+
+/**
+ *  @brief Class: ChunkedLog
+ *  @details Append-only log with exactly one producer thread and any number of reader threads. Elements are stored in chunks of
+ *  CHUNK_SIZE elements that are never moved or reallocated. The number of elements is published atomically after an element has been
+ *  written, readers always see a consistent prefix. Chunks are allocated ahead of the producer by @ref Reserve, so appending an element
+ *  does not allocate memory unless the producer overtakes the reserved chunks. Allocated chunks are kept until the log is destroyed.
+ */
+template <class T, size_t CHUNK_SIZE, size_t MAX_CHUNKS> class ChunkedLog {
+    public:
+        /**
+         *  @brief Create an empty log, no chunks are allocated.
+         */
+        ChunkedLog():size(0), numFallbackAllocations(0){
+            for(auto&& chunk : chunks){
+                chunk.store(nullptr);
+            }
+        }
+
+        /**
+         *  @brief Delete the log and all chunks.
+         */
+        ~ChunkedLog(){
+            for(auto&& chunk : chunks){
+                delete[] chunk.exchange(nullptr);
+            }
+        }
+
+        /**
+         *  @brief Remove all elements. Allocated chunks are kept for reuse.
+         *  @details Must only be called while neither the producer nor a reader is active.
+         */
+        void Clear(void){
+            size.store(0);
+            numFallbackAllocations.store(0);
+        }
+
+        /**
+         *  @brief Make sure that chunks for the next elements are allocated.
+         *  @param [in] numElements Number of elements after the current size for which chunks should be allocated.
+         *  @details May be called by the producer or by one other thread while the producer is active.
+         */
+        void Reserve(size_t numElements){
+            size_t first = size.load(std::memory_order_relaxed) / CHUNK_SIZE;
+            size_t last = std::min((size.load(std::memory_order_relaxed) + numElements + CHUNK_SIZE - 1) / CHUNK_SIZE, MAX_CHUNKS);
+            for(size_t c = first; c < last; c++){
+                (void) GetChunk(c);
+            }
+        }
+
+        /**
+         *  @brief Get the slot of the next element (producer only).
+         *  @return Pointer to the next element or nullptr if the log is full. The element becomes visible to readers by @ref Publish.
+         */
+        T* Next(void){
+            size_t index = size.load(std::memory_order_relaxed);
+            size_t c = index / CHUNK_SIZE;
+            if(c >= MAX_CHUNKS){
+                return nullptr;
+            }
+            T* chunk = chunks[c].load(std::memory_order_acquire);
+            if(!chunk){
+                numFallbackAllocations.fetch_add(1, std::memory_order_relaxed);
+                chunk = GetChunk(c);
+            }
+            return &chunk[index % CHUNK_SIZE];
+        }
+
+        /**
+         *  @brief Publish the element that has been obtained by @ref Next (producer only).
+         */
+        void Publish(void){
+            size.store(size.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         *  @brief Get the number of published elements.
+         *  @return Number of elements that can safely be accessed.
+         */
+        inline size_t GetSize(void) const { return size.load(std::memory_order_acquire); }
+
+        /**
+         *  @brief Get a published element.
+         *  @param [in] index Index of the element, must be less than the size that has been returned by @ref GetSize.
+         *  @return Reference to the element. Values that are changed after publishing must be accessed atomically.
+         */
+        inline T& operator[](size_t index){ return chunks[index / CHUNK_SIZE].load(std::memory_order_relaxed)[index % CHUNK_SIZE]; }
+        inline const T& operator[](size_t index) const { return chunks[index / CHUNK_SIZE].load(std::memory_order_relaxed)[index % CHUNK_SIZE]; }
+
+        /**
+         *  @brief Get the number of chunks that had to be allocated by the producer because they were not reserved in time.
+         *  @return Number of chunk allocations of the producer since the last call to @ref Clear.
+         */
+        inline uint32_t GetNumFallbackAllocations(void) const { return numFallbackAllocations.load(std::memory_order_relaxed); }
+
+    private:
+        std::array<std::atomic<T*>, MAX_CHUNKS> chunks;   ///< Chunks of elements.
+        std::atomic<size_t> size;                         ///< Number of published elements.
+        std::atomic<uint32_t> numFallbackAllocations;     ///< Number of chunks that have been allocated by the producer.
+
+        /**
+         *  @brief Get a chunk and allocate it if it does not exist yet.
+         *  @param [in] c Index of the chunk.
+         *  @return The chunk.
+         */
+        T* GetChunk(size_t c){
+            T* chunk = chunks[c].load(std::memory_order_acquire);
+            if(!chunk){
+                T* expected = nullptr;
+                chunk = new T[CHUNK_SIZE];
+                if(!chunks[c].compare_exchange_strong(expected, chunk, std::memory_order_acq_rel)){
+                    delete[] chunk;
+                    chunk = expected;
+                }
+            }
+            return chunk;
+        }
+};
+
@@ -0,0 +1,54 @@
+#include <MIDICapture.hpp>
+
+
+MIDICapture::State::State(){
+    Reset();
+}
+
+void MIDICapture::State::Reset(void){
+    runningStatus = 0x00;
+    droppedTime = 0.0;
+    numDroppedMessages = 0;
+    numDroppedNotes = 0;
+}
+
+void MIDICapture::Capture(NoteLog& notes, MIDIRecordLog& log, State& state, double absoluteTime, double timestamp, const uint8_t* message, uint32_t length){
+    // Check for running status
+    if(!length) return;
+    uint32_t index = 0;
+    if(0x80 & message[0]){
+        state.runningStatus = message[0];
+        index++;
+    }
+
+    // Process note on/off events
+    uint8_t status = state.runningStatus;
+    if((2 == (length - index)) && ((0x80 == (status & 0xF0)) || (0x90 == (status & 0xF0)))){
+        uint8_t key = message[index];
+        uint8_t vel = message[index + 1] & 0x7F;
+        bool noteOff = (0x80 == (status & 0xF0)) || ((0x90 == (status & 0xF0)) && !vel);
+
+        // only keys between A0 and C8
+        if((key >= 21) && (key <= 108)){
+            key -= 21;
+            if(!noteOff){
+                if(!notes.Append(key, double(vel) / 127.0, absoluteTime)){
+                    state.numDroppedNotes.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            else{
+                notes.SetOff(key, absoluteTime);
+            }
+        }
+    }
+
+    // Save raw data (no memory allocation), messages are only lost if the journal writer falls behind by more than the ring buffer.
+    // The delta time of a lost message is added to the next message, so that the timing of the remaining messages is kept.
+    if(log.Append(state.droppedTime + timestamp, message, length)){
+        state.droppedTime = 0.0;
+    }
+    else{
+        state.droppedTime += timestamp;
+        state.numDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+    }
+}
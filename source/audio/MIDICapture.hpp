@@ -0,0 +1,47 @@
+#pragma once
+
+
+#include <NoteLog.hpp>
+#include <MIDIRecordLog.hpp>
+
+
+/**
+ *  @brief Class: MIDICapture
+ *  @details Capture path of the recorder that runs on the MIDI input thread. A received message is appended to the raw record log and
+ *  note on/off messages update the note log. Nothing on this path allocates memory as long as the note log is reserved in time.
+ */
+class MIDICapture {
+    public:
+        class State {
+            public:
+                uint8_t runningStatus;                      ///< Running status byte (latest status).
+                double droppedTime;                         ///< Sum of the delta times of raw MIDI messages that have been dropped since the latest stored message.
+                std::atomic<uint32_t> numDroppedMessages;   ///< Number of raw MIDI messages that did not fit into the record log.
+                std::atomic<uint32_t> numDroppedNotes;      ///< Number of notes that did not fit into the note log.
+
+                /**
+                 *  @brief Create a reset capture state.
+                 */
+                State();
+
+                /**
+                 *  @brief Reset the capture state.
+                 *  @details Must only be called while the MIDI input thread does not capture messages.
+                 */
+                void Reset(void);
+        };
+
+        /**
+         *  @brief Capture a received MIDI message (MIDI input thread only).
+         *  @param [inout] notes The note log to which note on/off messages are written.
+         *  @param [inout] log The record log to which the raw message is appended.
+         *  @param [inout] state The capture state that is kept between messages.
+         *  @param [in] absoluteTime Time in seconds since the recording has been started.
+         *  @param [in] timestamp Delta time to the previous message in seconds.
+         *  @param [in] message Message bytes, the status byte may be omitted (running status).
+         *  @param [in] length Number of message bytes.
+         *  @details Messages and notes that do not fit into the logs are counted in the capture state.
+         */
+        static void Capture(NoteLog& notes, MIDIRecordLog& log, State& state, double absoluteTime, double timestamp, const uint8_t* message, uint32_t length);
+};
+
@@ -0,0 +1,53 @@
+#include <MIDIRecordLog.hpp>
+
+
+MIDIRecordLog::MIDIRecordLog(): records(MIDI_RECORD_LOG_CAPACITY), sysex(MIDI_RECORD_LOG_SYSEX_CAPACITY), size(0), sysexSize(0), numConsumed(0), sysexConsumed(0){}
+
+void MIDIRecordLog::Clear(void){
+    size.store(0);
+    sysexSize = 0;
+    numConsumed.store(0);
+    sysexConsumed.store(0);
+}
+
+bool MIDIRecordLog::Append(double timestamp, const uint8_t* bytes, uint32_t length){
+    size_t index = size.load(std::memory_order_relaxed);
+    if(!length || ((index - numConsumed.load(std::memory_order_acquire)) >= MIDI_RECORD_LOG_CAPACITY)){
+        return false;
+    }
+    Record& record = records[index & (MIDI_RECORD_LOG_CAPACITY - 1)];
+    record.timestamp = timestamp;
+    record.offset = 0;
+    record.length = length;
+    if(length <= MIDI_RECORD_LOG_INLINE_SIZE){
+        std::memcpy(record.data, bytes, length);
+    }
+    else{
+        if((sysexSize + length - sysexConsumed.load(std::memory_order_acquire)) > MIDI_RECORD_LOG_SYSEX_CAPACITY){
+            return false;
+        }
+        record.offset = sysexSize;
+        for(uint32_t i = 0; i < length; i++){
+            sysex[(sysexSize + i) & (MIDI_RECORD_LOG_SYSEX_CAPACITY - 1)] = bytes[i];
+        }
+        sysexSize += length;
+    }
+
+    // The record and its message bytes become visible to the consumer at once
+    size.store(index + 1, std::memory_order_release);
+    return true;
+}
+
+void MIDIRecordLog::Consume(size_t index){
+    // Release the sysex bytes of the consumed records before the records themselves
+    size_t first = numConsumed.load(std::memory_order_relaxed);
+    size_t bytesConsumed = sysexConsumed.load(std::memory_order_relaxed);
+    for(size_t i = first; i < index; i++){
+        const Record& record = Get(i);
+        if(record.length > MIDI_RECORD_LOG_INLINE_SIZE){
+            bytesConsumed = record.offset + record.length;
+        }
+    }
+    sysexConsumed.store(bytesConsumed, std::memory_order_release);
+    numConsumed.store(index, std::memory_order_release);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+
+#define MIDI_RECORD_LOG_CAPACITY           (65536)     ///< Number of records of the ring buffer (power of two).
+#define MIDI_RECORD_LOG_SYSEX_CAPACITY     (1 << 20)   ///< Number of bytes of the sysex ring buffer (power of two).
+#define MIDI_RECORD_LOG_INLINE_SIZE        (3)         ///< Maximum number of bytes of a message that is stored inside the record.
+
+
+/**
+ *  @brief Class: MIDIRecordLog
+ *  @details Bounded ring buffer of raw MIDI messages with exactly one producer thread (the MIDI input thread) and exactly one consumer
+ *  thread (the journal writer). Channel messages are stored in fixed-size records, longer messages (sysex) are stored in a separate byte
+ *  ring that is referenced by the record. Both rings are allocated once by the constructor, so the memory usage does not grow during
+ *  recording and appending a message never allocates memory. Slots are reused as soon as the consumer has released them by @ref Consume.
+ *  If the consumer falls behind by more than the capacity, @ref Append rejects the message and the caller has to account for it.
+ */
+class MIDIRecordLog {
+    public:
+        class Record {
+            public:
+                double timestamp;                               ///< Delta time to the previous message in seconds.
+                size_t offset;                                  ///< Position of the message bytes in the sysex ring (only if length exceeds the inline size).
+                uint32_t length;                                ///< Number of message bytes including the status byte.
+                uint8_t data[MIDI_RECORD_LOG_INLINE_SIZE];      ///< Message bytes (only if length does not exceed the inline size).
+        };
+
+        /**
+         *  @brief Create an empty MIDI record log and allocate both ring buffers.
+         */
+        MIDIRecordLog();
+
+        /**
+         *  @brief Remove all records.
+         *  @details Must only be called while neither the producer nor the consumer is active.
+         */
+        void Clear(void);
+
+        /**
+         *  @brief Append a MIDI message (producer only).
+         *  @param [in] timestamp Delta time to the previous message in seconds.
+         *  @param [in] bytes Message bytes including the status byte.
+         *  @param [in] length Number of message bytes, must be greater than zero.
+         *  @return True if success, false if the message does not fit into the space that has been released by the consumer.
+         */
+        bool Append(double timestamp, const uint8_t* bytes, uint32_t length);
+
+        /**
+         *  @brief Get the number of records that have been appended since the last call to @ref Clear.
+         *  @return Index after the latest record that can safely be accessed by @ref Get.
+         */
+        inline size_t GetSize(void) const { return size.load(std::memory_order_acquire); }
+
+        /**
+         *  @brief Get a record (consumer only).
+         *  @param [in] index Index of the record, must be less than the size that has been returned by @ref GetSize and must not have been consumed.
+         *  @return The record.
+         */
+        inline const Record& Get(size_t index) const { return records[index & (MIDI_RECORD_LOG_CAPACITY - 1)]; }
+
+        /**
+         *  @brief Get a message byte of a record (consumer only).
+         *  @param [in] record A record that has been returned by @ref Get.
+         *  @param [in] index Index of the byte, must be less than the length of the record.
+         *  @return The message byte.
+         */
+        inline uint8_t GetByte(const Record& record, uint32_t index) const { return (record.length > MIDI_RECORD_LOG_INLINE_SIZE) ? sysex[(record.offset + index) & (MIDI_RECORD_LOG_SYSEX_CAPACITY - 1)] : record.data[index]; }
+
+        /**
+         *  @brief Release all records before an index, so that the producer can reuse their slots (consumer only).
+         *  @param [in] index Index after the latest record that has been processed, must not exceed the size that has been returned by @ref GetSize.
+         */
+        void Consume(size_t index);
+
+    private:
+        std::vector<Record> records;                 ///< Ring buffer of records.
+        std::vector<uint8_t> sysex;                  ///< Ring buffer for messages that do not fit into a record.
+        std::atomic<size_t> size;                    ///< Number of published records.
+        size_t sysexSize;                            ///< Number of bytes that have been written to the sysex ring (producer only).
+        std::atomic<size_t> numConsumed;             ///< Number of records that have been released by the consumer.
+        std::atomic<size_t> sysexConsumed;           ///< Number of bytes of the sysex ring that have been released by the consumer.
+};
+
@@ -0,0 +1,58 @@
+#include <NoteLog.hpp>
+
+
+NoteLog::NoteLog(){}
+
+void NoteLog::Clear(void){
+    for(auto&& lane : lanes){
+        lane.Clear();
+    }
+}
+
+void NoteLog::Reserve(void){
+    for(auto&& lane : lanes){
+        lane.Reserve(NOTE_LOG_CHUNK_SIZE);
+    }
+}
+
+uint32_t NoteLog::GetNumFallbackAllocations(void) const {
+    uint32_t num = 0;
+    for(auto&& lane : lanes){
+        num += lane.GetNumFallbackAllocations();
+    }
+    return num;
+}
+
+bool NoteLog::Append(int lane, double velocity, double on){
+    // A previous note that is still on (double note on or lost note off) ends with this note, like in Sequencer::Generate
+    size_t size = lanes[lane].GetSize();
+    if(size){
+        Note& previous = lanes[lane][size - 1];
+        double off = previous.off.load(std::memory_order_relaxed);
+        if(off > on){
+            previous.off.store(std::max(previous.on, on), std::memory_order_release);
+        }
+    }
+
+    // Write the note before it is published
+    Note* note = lanes[lane].Next();
+    if(!note){
+        return false;
+    }
+    note->velocity = velocity;
+    note->on = on;
+    note->off.store(std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+    lanes[lane].Publish();
+    return true;
+}
+
+void NoteLog::SetOff(int lane, double off){
+    // A stray or duplicate note off must not extend a note that is already off
+    size_t size = lanes[lane].GetSize();
+    if(size){
+        Note& note = lanes[lane][size - 1];
+        if(std::isinf(note.off.load(std::memory_order_relaxed))){
+            note.off.store(off, std::memory_order_release);
+        }
+    }
+}
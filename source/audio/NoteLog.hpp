@@ -0,0 +1,86 @@
+#pragma once
+
+
+#include <ChunkedLog.hpp>
+
+
+#define NOTE_LOG_CHUNK_SIZE    (1024)   ///< Number of notes per chunk.
+#define NOTE_LOG_MAX_CHUNKS    (1024)   ///< Maximum number of chunks per lane.
+
+
+/**
+ *  @brief Class: NoteLog
+ *  @details Append-only log of notes for all 88 lanes with exactly one producer thread and any number of reader threads.
+ *  Each lane is a @ref ChunkedLog, so readers never block the producer and always see a consistent prefix of a lane.
+ *  The note off time is the only value that is updated in place, it is an atomic value.
+ */
+class NoteLog {
+    public:
+        class Note {
+            public:
+                double velocity;            ///< Normalized velocity in range [0.0, 1.0].
+                double on;                  ///< Time in seconds when note is on.
+                std::atomic<double> off;    ///< Time in seconds when note is off (infinity while the note is on).
+        };
+
+        /**
+         *  @brief Create an empty note log.
+         */
+        NoteLog();
+
+        /**
+         *  @brief Remove all notes. Allocated chunks are kept for reuse.
+         *  @details Must only be called while neither the producer nor a reader is active.
+         */
+        void Clear(void);
+
+        /**
+         *  @brief Make sure that the next chunk of every lane is allocated, so that the producer does not have to allocate memory.
+         *  @details May be called by one thread other than the producer while the producer is active.
+         */
+        void Reserve(void);
+
+        /**
+         *  @brief Get the number of chunks that had to be allocated by the producer.
+         *  @return Number of chunk allocations of the producer of all lanes since the last call to @ref Clear.
+         */
+        uint32_t GetNumFallbackAllocations(void) const;
+
+        /**
+         *  @brief Append a note that is on (producer only).
+         *  @param [in] lane Lane index in range [0, 87].
+         *  @param [in] velocity Normalized velocity in range [0.0, 1.0].
+         *  @param [in] on Time in seconds when note is on.
+         *  @return True if success, false if the lane is full.
+         *  @details If the previous note of the lane is still on, its note off time is set to the note on time of the new note. Only the
+         *  latest note of a lane can be on, so a double note on or a lost note off does not leave a note that is on forever.
+         */
+        bool Append(int lane, double velocity, double on);
+
+        /**
+         *  @brief Set the note off time of the latest note of a lane (producer only).
+         *  @param [in] lane Lane index in range [0, 87].
+         *  @param [in] off Time in seconds when note is off.
+         *  @details Nothing is changed if the latest note is already off.
+         */
+        void SetOff(int lane, double off);
+
+        /**
+         *  @brief Get the number of notes of a lane.
+         *  @param [in] lane Lane index in range [0, 87].
+         *  @return Number of notes that can safely be accessed by @ref Get.
+         */
+        inline size_t GetSize(int lane) const { return lanes[lane].GetSize(); }
+
+        /**
+         *  @brief Get a note.
+         *  @param [in] lane Lane index in range [0, 87].
+         *  @param [in] index Index of the note, must be less than the size that has been returned by @ref GetSize.
+         *  @return The note, the off time has to be loaded atomically.
+         */
+        inline const Note& Get(int lane, size_t index) const { return lanes[lane][index]; }
+
+    private:
+        std::array<ChunkedLog<Note, NOTE_LOG_CHUNK_SIZE, NOTE_LOG_MAX_CHUNKS>, 88> lanes;   ///< All lanes.
+};
+
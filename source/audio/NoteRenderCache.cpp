@@ -0,0 +1,66 @@
+#include <NoteRenderCache.hpp>
+
+
+NoteRenderCache::NoteRenderCache(size_t capacity){
+    this->capacity = capacity;
+    numBytes = 0;
+    numHits = 0;
+    numMisses = 0;
+}
+
+NoteRenderCache::Waveform NoteRenderCache::Find(const Key& key){
+    std::lock_guard<std::mutex> lock(mtx);
+    auto got = lookup.find(key);
+    if(got == lookup.end()){
+        numMisses++;
+        return nullptr;
+    }
+    numHits++;
+    entries.splice(entries.begin(), entries, got->second);
+    return got->second->second;
+}
+
+void NoteRenderCache::Insert(const Key& key, Waveform waveform){
+    size_t size = waveform ? (waveform->size() * sizeof(float)) : 0;
+    if(!size || (size > capacity)){
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+
+    // Another thread may have inserted the same waveform in the meantime
+    if(lookup.find(key) != lookup.end()){
+        return;
+    }
+    while(!entries.empty() && ((numBytes + size) > capacity)){
+        numBytes -= entries.back().second->size() * sizeof(float);
+        lookup.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.push_front(std::make_pair(key, waveform));
+    lookup.insert({key, entries.begin()});
+    numBytes += size;
+}
+
+void NoteRenderCache::Clear(void){
+    std::lock_guard<std::mutex> lock(mtx);
+    lookup.clear();
+    entries.clear();
+    numBytes = 0;
+    numHits = 0;
+    numMisses = 0;
+}
+
+void NoteRenderCache::Release(void){
+    std::lock_guard<std::mutex> lock(mtx);
+    lookup.clear();
+    entries.clear();
+    numBytes = 0;
+}
+
+void NoteRenderCache::GetStatistics(double& hitRate, size_t& numBytes){
+    std::lock_guard<std::mutex> lock(mtx);
+    uint64_t numLookups = numHits + numMisses;
+    hitRate = numLookups ? ((double)numHits / (double)numLookups) : 0.0;
+    numBytes = this->numBytes;
+}
+
@@ -0,0 +1,86 @@
+#pragma once
+
+
+/**
+ *  @brief Class: NoteRenderCache
+ *  @details Thread-safe least recently used cache of rendered note waveforms. A waveform contains the stereo interleaved samples
+ *  of a single note (sustain and release segment) rendered from a silent synthesizer. The total size of all waveforms is bounded,
+ *  the least recently used waveforms are evicted first. Waveforms are shared, so evicting a waveform never invalidates a waveform that is in use.
+ */
+class NoteRenderCache {
+    public:
+        class Key {
+            public:
+                int32_t presetIndex;          ///< Index of the sound font preset.
+                uint8_t key;                  ///< MIDI key number.
+                uint8_t velocity;             ///< MIDI velocity in range [1, 127].
+                uint32_t numSustainFrames;    ///< Number of frames between note on and note off.
+                uint32_t numReleaseFrames;    ///< Maximum number of frames after note off.
+
+                bool operator==(const Key& rhs) const {
+                    return (presetIndex == rhs.presetIndex) && (key == rhs.key) && (velocity == rhs.velocity) && (numSustainFrames == rhs.numSustainFrames) && (numReleaseFrames == rhs.numReleaseFrames);
+                }
+        };
+
+        typedef std::shared_ptr<const std::vector<float>> Waveform;
+
+        /**
+         *  @brief Create an empty note render cache.
+         *  @param [in] capacity Maximum total size of all waveforms in bytes.
+         */
+        explicit NoteRenderCache(size_t capacity);
+
+        /**
+         *  @brief Find a waveform and mark it as most recently used.
+         *  @param [in] key The key of the waveform.
+         *  @return The waveform or nullptr if it is not in the cache.
+         */
+        Waveform Find(const Key& key);
+
+        /**
+         *  @brief Insert a waveform and evict least recently used waveforms until the cache fits its capacity.
+         *  @param [in] key The key of the waveform.
+         *  @param [in] waveform The waveform. Waveforms that exceed the capacity on their own are not inserted.
+         */
+        void Insert(const Key& key, Waveform waveform);
+
+        /**
+         *  @brief Remove all waveforms and reset the statistics.
+         */
+        void Clear(void);
+
+        /**
+         *  @brief Remove all waveforms but keep the statistics.
+         *  @details Waveforms that are still in use remain valid until they are released by their users.
+         */
+        void Release(void);
+
+        /**
+         *  @brief Get statistics of the cache.
+         *  @param [out] hitRate Ratio of successful lookups to all lookups, zero if there was no lookup.
+         *  @param [out] numBytes Total size of all waveforms in bytes.
+         */
+        void GetStatistics(double& hitRate, size_t& numBytes);
+
+    private:
+        class KeyHash {
+            public:
+                size_t operator()(const Key& k) const {
+                    uint64_t h = ((uint64_t)(uint32_t)k.presetIndex << 16) ^ ((uint64_t)k.key << 8) ^ (uint64_t)k.velocity;
+                    h = h * 0x9E3779B97F4A7C15ULL ^ (uint64_t)k.numSustainFrames;
+                    h = h * 0x9E3779B97F4A7C15ULL ^ (uint64_t)k.numReleaseFrames;
+                    return (size_t)(h ^ (h >> 29));
+                }
+        };
+
+        typedef std::list<std::pair<Key, Waveform>> EntryList;
+
+        std::mutex mtx;                                                         ///< Protects all members.
+        size_t capacity;                                                        ///< Maximum total size of all waveforms in bytes.
+        size_t numBytes;                                                        ///< Total size of all waveforms in bytes.
+        uint64_t numHits;                                                       ///< Number of successful lookups.
+        uint64_t numMisses;                                                     ///< Number of failed lookups.
+        EntryList entries;                                                      ///< All entries, most recently used first.
+        std::unordered_map<Key, EntryList::iterator, KeyHash> lookup;           ///< Maps keys to entries.
+};
+
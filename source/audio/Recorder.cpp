@@ -1,18 +1,14 @@
 #include <Recorder.hpp>
 #include <MainWindow.hpp>
-#include <MIDIFile.hpp>
 
 
 Recorder::Recorder(){
-    track.channel = 0;
-    track.name.clear();
-    track.instrumentType = 0;
-    track.colorWhiteKey = glm::u8vec3(180,0,0);
-    track.colorBlackKey = glm::u8vec3(100,0,0);
+    colorWhiteKey = glm::u8vec3(180,0,0);
+    colorBlackKey = glm::u8vec3(100,0,0);
     midiIn = nullptr;
-    runningStatus = 0x00;
     isRecording = false;
     latestTimePointer = 0.0;
+    hasJournal = false;
 }
 
 Recorder::~Recorder(){
@@ -31,15 +27,12 @@ bool Recorder::StartRecording(void){
     // Make sure that recording is stopped
     StopRecording();
 
-    // Reset track
-    rawRecordedData.clear();
-    mtxTrack.lock();
-    for(int i = 0; i < 88; i++){
-        track.lanes[i].clear();
-    }
-    mtxTrack.unlock();
-    runningStatus = 0x00;
+    // Reset recorded data (the MIDI callback is not active)
+    rawRecordedData.Clear();
+    notes.Clear();
+    captureState.Reset();
     latestTimePointer = 0.0;
+    Reserve();
 
     // Create RT-MIDI object
     try{
@@ -79,19 +72,70 @@ bool Recorder::StartRecording(void){
         (void)midiIn->getMessage(&msg);
     } while(msg.size());
 
+    // An unfinished journal that could not be recovered is kept under a new name instead of being overwritten
+    std::string journalFilename = GetDirectory() + RECORDER_JOURNAL_FILENAME;
+    bool journalAvailable = true;
+    if(RecordingJournal::IsUnfinished(journalFilename)){
+        std::string keptFilename = GenerateFilename(".journal");
+        journalAvailable = !std::rename(journalFilename.c_str(), keptFilename.c_str());
+        if(journalAvailable){
+            LogWarning("Unfinished recording journal has been kept as \"%s\"\n", keptFilename.c_str());
+        }
+        else{
+            LogError("Could not rename unfinished recording journal \"%s\"!\n", journalFilename.c_str());
+        }
+    }
+
+    // Start writing the recording journal
+    hasJournal = false;
+    if(!journalAvailable || !journal.Open(journalFilename, &rawRecordedData)){
+        midiIn->closePort();
+        delete midiIn;
+        midiIn = nullptr;
+        MainWindow::canvas.renderer.SetPostProcessingColorScale(glm::vec3(1.0f));
+        return false;
+    }
+
     // Set callback and return success
+    hasJournal = true;
     void *userData = (void*)this;
     midiIn->setCallback(&(Recorder::CallbackMidiIn), userData);
     return true;
 }
 
+void Recorder::Reserve(void){
+    notes.Reserve();
+}
+
+uint32_t Recorder::GetNumFallbackAllocations(void) const {
+    return notes.GetNumFallbackAllocations();
+}
+
+void Recorder::GetNumDropped(uint32_t& numMessages, uint32_t& numNotes) const {
+    numMessages = captureState.numDroppedMessages.load(std::memory_order_relaxed);
+    numNotes = captureState.numDroppedNotes.load(std::memory_order_relaxed);
+}
+
 void Recorder::StopRecording(void){
     if(midiIn){
         midiIn->cancelCallback();
         midiIn->closePort();
+        journal.Close();
         delete midiIn;
         midiIn = nullptr;
         MainWindow::canvas.renderer.SetPostProcessingColorScale(glm::vec3(1.0f));
+        uint32_t numFallbackAllocations = GetNumFallbackAllocations();
+        if(numFallbackAllocations){
+            LogWarning("The MIDI thread had to allocate memory %u times during recording!\n", numFallbackAllocations);
+        }
+        uint32_t numMessages, numNotes;
+        GetNumDropped(numMessages, numNotes);
+        if(numMessages){
+            LogWarning("%u MIDI messages could not be written to the recording journal and are missing in the recording!\n", numMessages);
+        }
+        if(numNotes){
+            LogWarning("%u notes could not be displayed because the note log is full!\n", numNotes);
+        }
     }
     isRecording = false;
 }
@@ -100,50 +144,41 @@ void Recorder::ReceiveMIDI(double timestamp, std::vector<unsigned char>& message
     // Start actual recording when first message is received
     double absoluteTime = 0.0;
     if(!isRecording){
-        isRecording = true;
         timeOfStart = std::chrono::steady_clock::now();
+        isRecording = true;
     }
     else{
         auto timeNow = std::chrono::steady_clock::now();
         absoluteTime = 1e-9 * double(std::chrono::duration_cast<std::chrono::nanoseconds>(timeNow - timeOfStart).count());
     }
 
-    // Check for running status
-    if(!message.size()) return;
-    int index = 0;
-    if(0x80 & message[0]){
-        runningStatus = message[0];
-        index++;
-    }
+    // Capture the message without allocating memory
+    MIDICapture::Capture(notes, rawRecordedData, captureState, absoluteTime, timestamp, message.data(), (uint32_t)message.size());
+}
 
-    // Process note on/off events
-    if((2 == ((int)message.size() - index)) && ((0x80 == (runningStatus & 0xF0)) || (0x90 == (runningStatus & 0xF0)))){
-        uint8_t key = message[index];
-        uint8_t vel = message[index + 1] & 0x7F;
-        bool noteOff = (0x80 == (runningStatus & 0xF0)) || ((0x90 == (runningStatus & 0xF0)) && !vel);
-
-        // only keys between A0 and C8
-        if((key >= 21) && (key <= 108)){
-            key -= 21;
-            mtxTrack.lock();
-            if(!noteOff){
-                track.lanes[key].push_back(NoteBlock(double(vel) / 127.0, absoluteTime));
-            }
-            else if(track.lanes[key].size()){
-                track.lanes[key].back().off = absoluteTime;
-            }
-            mtxTrack.unlock();
-        }
+bool Recorder::Save(void){
+    if(!hasJournal){
+        LogError("Nothing has been recorded yet!\n");
+        return false;
     }
-
-    // Save raw data
-    rawRecordedData.push_back({timestamp, std::move(message)});
+    return RecordingJournal::Finalize(GetDirectory() + RECORDER_JOURNAL_FILENAME, GenerateFilename());
 }
 
-bool Recorder::Save(void){
-    const std::lock_guard<std::mutex> lock(mtxTrack);
+void Recorder::Recover(void){
+    std::string journalFilename = GetDirectory() + RECORDER_JOURNAL_FILENAME;
+    if(!RecordingJournal::IsUnfinished(journalFilename)){
+        return;
+    }
+    std::string filename = GenerateFilename();
+    if(!RecordingJournal::Finalize(journalFilename, filename)){
+        LogError("Could not recover unfinished recording journal \"%s\"!\n", journalFilename.c_str());
+        return;
+    }
+    (void) RecordingJournal::MarkClosed(journalFilename);
+    LogMessage("Recovered unfinished recording to \"%s\"\n", filename.c_str());
+}
 
-    // Directory of application
+std::string Recorder::GetDirectory(void){
     char* buffer = new char[65536];
     #ifdef _WIN32
     DWORD len = GetModuleFileName(NULL, (LPSTR)(&buffer[0]), (DWORD)65536);
@@ -154,64 +189,15 @@ bool Recorder::Save(void){
     auto found = str.find_last_of("/\\");
     std::string path = str.substr(0, found + 1);
     delete[] buffer;
+    return path;
+}
 
-    // Generate filename
+std::string Recorder::GenerateFilename(std::string extension){
     auto systemClock = std::chrono::system_clock::now();
     std::time_t systemTime = std::chrono::system_clock::to_time_t(systemClock);
     std::tm* gmTime = std::gmtime(&systemTime);
     char name[64];
-    sprintf(name,"Recording%d%02d%02d%02d%02d%02d.mid", gmTime->tm_year + 1900, gmTime->tm_mon + 1, gmTime->tm_mday, gmTime->tm_hour, gmTime->tm_min, gmTime->tm_sec);
-    std::string filename = path + std::string(name);
-
-    // MIDI Header
-    MIDIFile midi;
-    midi.header.format = 1;        // multi-track
-    midi.header.numTracks = 2;     // 2 tracks
-    midi.header.division = 0x7800; // ticks per quarter note: 30720
-    double time2Ticks = (double)(midi.header.division) / 0.5; // 0.5 because of 120 BPM
-
-    // MIDI Track 1 (info track)
-    midi.tracks.push_back(MIDIChunkTrack());
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xFF;    midi.tracks.back().events.back().data = {0x03, 0x00};                          // Name: ""
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xFF;    midi.tracks.back().events.back().data = {0x51, 0x03, 0x07, 0xA1, 0x20};        // Tempo: 120 BPM
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xFF;    midi.tracks.back().events.back().data = {0x58, 0x04, 0x04, 0x02, 0x07, 0xA1};  // Time signatur: 4/4
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xFF;    midi.tracks.back().events.back().data = {0x2F, 0x00};                          // End of track
-
-    // MIDI Track 2 (instrument track)
-    midi.tracks.push_back(MIDIChunkTrack());
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xFF;    midi.tracks.back().events.back().data = {0x03, 0x00};                          // Name: ""
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xC0;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 0 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xC1;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 1 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xC2;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 2 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xC3;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 3 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xC4;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 4 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xC5;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 5 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xC6;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 6 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xC7;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 7 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xC8;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 8 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xC9;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 9 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xCA;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 10 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xCB;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 11 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xCC;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 12 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xCD;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 13 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xCE;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 14 -> Piano
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xCF;    midi.tracks.back().events.back().data = {0x00};                                // Program Change: Channel 15 -> Piano
-    double tickError = 0.0;
-    for(auto&& msg : rawRecordedData){
-        if(msg.second.size()){
-            double tick = tickError + time2Ticks * msg.first;
-            midi.tracks.back().events.push_back(MIDIEvent());
-            midi.tracks.back().events.back().deltaTime = (uint32_t)tick;
-            tickError = (tick - (double)midi.tracks.back().events.back().deltaTime);
-            midi.tracks.back().events.back().status = msg.second[0];
-            for(int i = 1; i < (int)msg.second.size(); i++){
-                midi.tracks.back().events.back().data.push_back(msg.second[i]);
-            }
-        }
-    }
-    midi.tracks.back().events.push_back(MIDIEvent());    midi.tracks.back().events.back().deltaTime = 0;    midi.tracks.back().events.back().status = 0xFF;    midi.tracks.back().events.back().data = {0x2F, 0x00};                          // End of track
-
-    // Write MIDI file
-    return midi.Write(filename);
+    sprintf(name,"Recording%d%02d%02d%02d%02d%02d", gmTime->tm_year + 1900, gmTime->tm_mon + 1, gmTime->tm_mday, gmTime->tm_hour, gmTime->tm_min, gmTime->tm_sec);
+    return GetDirectory() + std::string(name) + extension;
 }
 
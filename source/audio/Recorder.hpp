@@ -1,15 +1,20 @@
 #pragma once
 
 
-#include <SequenceTrack.hpp>
+#include <MIDICapture.hpp>
+#include <RecordingJournal.hpp>
 #include <RtMidi.h>
 
 
+#define RECORDER_JOURNAL_FILENAME   "Recording.journal"   ///< Filename of the recording journal inside the application directory.
+
+
 class Recorder {
     public:
-        SequenceTrack track; ///< Track data for visualization.
-        std::mutex mtxTrack; ///< Protect @ref track.
-        std::vector<std::pair<double, std::vector<unsigned char>>> rawRecordedData; ///< Raw MIDI data received during recording (delta time [s], data bytes).
+        NoteLog notes;                ///< Recorded notes for visualization (written by the MIDI thread, read by the render thread without locking).
+        glm::u8vec3 colorWhiteKey;    ///< Color for white keys.
+        glm::u8vec3 colorBlackKey;    ///< Color for black keys.
+        MIDIRecordLog rawRecordedData; ///< Raw MIDI messages received during recording (written by the MIDI thread without allocating memory, drained by the journal).
 
         /**
          *  @brief Create an empty recorder.
@@ -30,10 +35,30 @@ class Recorder {
         /**
          *  @brief Start recording.
          *  @return True if success, false otherwise.
-         *  @details The @ref track is cleared before the actual recording is started.
+         *  @details The @ref notes are cleared before the actual recording is started. An unfinished recording journal that could not be
+         *  recovered is renamed instead of being overwritten by the new journal.
          */
         bool StartRecording(void);
 
+        /**
+         *  @brief Allocate storage for the @ref notes ahead of the MIDI thread, so that receiving MIDI messages does not allocate memory.
+         *  @details Should be called regularly by one thread (e.g. once per frame) while recording.
+         */
+        void Reserve(void);
+
+        /**
+         *  @brief Get the number of chunks that had to be allocated by the MIDI thread because they were not reserved in time.
+         *  @return Number of chunk allocations of the MIDI thread since recording has been started.
+         */
+        uint32_t GetNumFallbackAllocations(void) const;
+
+        /**
+         *  @brief Get the number of MIDI messages and notes that were lost because the journal writer or the note log could not keep up.
+         *  @param [out] numMessages Number of raw MIDI messages that are missing in the recording journal.
+         *  @param [out] numNotes Number of notes that are missing in the @ref notes.
+         */
+        void GetNumDropped(uint32_t& numMessages, uint32_t& numNotes) const;
+
         /**
          *  @brief Stop recording.
          */
@@ -48,15 +73,25 @@ class Recorder {
         /**
          *  @brief Save recording to a MIDI file.
          *  @return True if success, false otherwise.
+         *  @details The MIDI file is generated from the recording journal, not from the data in memory. Only a recording that has been
+         *  made since the recorder has been created can be saved, a journal of a previous session is never exported again.
          */
         bool Save(void);
 
+        /**
+         *  @brief Recover a recording journal that has not been closed regularly (e.g. because of a crash) and save it to a MIDI file.
+         *  @details The recovered journal is marked as closed, so it is only recovered once.
+         */
+        static void Recover(void);
+
     private:
         RtMidiIn* midiIn;                                                ///< MIDI input object.
-        uint8_t runningStatus;                                           ///< Running status byte (latest status).
         std::chrono::time_point<std::chrono::steady_clock> timeOfStart;  ///< Time when first MIDI message was received.
         std::atomic<bool> isRecording;                                   ///< True if actual recording has been started, false otherwise.
         double latestTimePointer;                                        ///< The latest timepointer.
+        RecordingJournal journal;                                        ///< Writes the raw MIDI messages to disk while recording.
+        MIDICapture::State captureState;                                 ///< Running status and dropped messages of the MIDI thread.
+        bool hasJournal;                                                 ///< True if the recording journal has been written since the recorder has been created.
 
         /**
          *  @brief Callback function that receives MIDI data.
@@ -64,6 +99,19 @@ class Recorder {
          *  @param [in] message Received MIDI message.
          */
         void ReceiveMIDI(double timestamp, std::vector<unsigned char>& message);
+
+        /**
+         *  @brief Get the directory of the application.
+         *  @return The directory including a trailing path separator.
+         */
+        static std::string GetDirectory(void);
+
+        /**
+         *  @brief Generate a filename for a new file from the current date and time.
+         *  @param [in] extension The file extension including the dot, defaults to ".mid".
+         *  @return The absolute filename of the file.
+         */
+        static std::string GenerateFilename(std::string extension = ".mid");
         static void CallbackMidiIn(double timestamp, std::vector<unsigned char> *message, void *userData){ ((Recorder*)userData)->ReceiveMIDI(timestamp, *message); }
 };
 
@@ -0,0 +1,183 @@
+#include <RecordingJournal.hpp>
+#include <MIDIFileWriter.hpp>
+
+
+RecordingJournal::RecordingJournal(){
+    log = nullptr;
+    running = false;
+}
+
+RecordingJournal::~RecordingJournal(){
+    Close();
+}
+
+bool RecordingJournal::Open(std::string filename, MIDIRecordLog* log){
+    Close();
+    file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!file.is_open()){
+        LogError("Could not open journal \"%s\"!\n", filename.c_str());
+        return false;
+    }
+    const uint8_t header[8] = {'C', 'K', 'R', 'J', 0x00, 0x00, 0x00, 0x00};
+    file.write((const char*)&header[0], sizeof(header));
+    file.flush();
+    if(!file.good()){
+        LogError("Could not write journal \"%s\"!\n", filename.c_str());
+        file.close();
+        return false;
+    }
+    this->log = log;
+    buffer.clear();
+    buffer.reserve(RECORDING_JOURNAL_BUFFER_SIZE);
+    running = true;
+    writer = std::thread(&RecordingJournal::Write, this);
+    return true;
+}
+
+void RecordingJournal::Close(void){
+    if(writer.joinable()){
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            running = false;
+        }
+        cv.notify_one();
+        writer.join();
+    }
+    if(file.is_open()){
+        const uint8_t closed = 0x01;
+        file.seekp(4, std::ios::beg);
+        file.write((const char*)&closed, 1);
+        file.close();
+    }
+    log = nullptr;
+}
+
+bool RecordingJournal::IsUnfinished(std::string filename){
+    std::ifstream journal(filename, std::ios::in | std::ios::binary);
+    uint8_t header[8];
+    if(!journal.read((char*)&header[0], sizeof(header))){
+        return false;
+    }
+    return (0 == std::memcmp(&header[0], "CKRJ", 4)) && !header[4];
+}
+
+bool RecordingJournal::MarkClosed(std::string filename){
+    std::fstream journal(filename, std::ios::in | std::ios::out | std::ios::binary);
+    if(!journal.is_open()){
+        return false;
+    }
+    const uint8_t closed = 0x01;
+    journal.seekp(4, std::ios::beg);
+    journal.write((const char*)&closed, 1);
+    return journal.good();
+}
+
+bool RecordingJournal::Finalize(std::string journalFilename, std::string midiFilename){
+    std::ifstream journal(journalFilename, std::ios::in | std::ios::binary);
+    uint8_t header[8];
+    if(!journal.read((char*)&header[0], sizeof(header)) || std::memcmp(&header[0], "CKRJ", 4)){
+        LogError("Could not read journal \"%s\"!\n", journalFilename.c_str());
+        return false;
+    }
+    MIDIFileWriter writer;
+    if(!writer.Open(midiFilename)){
+        return false;
+    }
+
+    // MIDI Header
+    MIDIChunkHeader midiHeader;
+    midiHeader.format = 1;        // multi-track
+    midiHeader.numTracks = 2;     // 2 tracks
+    midiHeader.division = 0x7800; // ticks per quarter note: 30720
+    double time2Ticks = (double)(midiHeader.division) / 0.5; // 0.5 because of 120 BPM
+    (void) writer.WriteHeader(midiHeader);
+
+    // MIDI Track 1 (info track)
+    (void) writer.BeginTrack();
+    (void) writer.WriteEvent(0, 0xFF, {0x03, 0x00});                          // Name: ""
+    (void) writer.WriteEvent(0, 0xFF, {0x51, 0x03, 0x07, 0xA1, 0x20});        // Tempo: 120 BPM
+    (void) writer.WriteEvent(0, 0xFF, {0x58, 0x04, 0x04, 0x02, 0x07, 0xA1});  // Time signatur: 4/4
+    (void) writer.WriteEvent(0, 0xFF, {0x2F, 0x00});                          // End of track
+    (void) writer.EndTrack();
+
+    // MIDI Track 2 (instrument track)
+    (void) writer.BeginTrack();
+    (void) writer.WriteEvent(0, 0xFF, {0x03, 0x00});                          // Name: ""
+    for(uint8_t channel = 0; channel < 16; channel++){
+        (void) writer.WriteEvent(0, 0xC0 | channel, {0x00});                  // Program Change: Channel -> Piano
+    }
+
+    // Stream all complete journal records, messages that use running status get the status byte of the previous channel message
+    double tickError = 0.0;
+    uint8_t runningStatus = 0x00;
+    std::vector<uint8_t> message;
+    for(;;){
+        double timestamp;
+        uint32_t size;
+        if(!journal.read((char*)&timestamp, sizeof(timestamp)) || !journal.read((char*)&size, sizeof(size)) || !size || (size > RECORDING_JOURNAL_MAX_RECORD_SIZE)){
+            break;
+        }
+        message.resize(size);
+        if(!journal.read((char*)message.data(), size)){
+            break;
+        }
+        double tick = tickError + time2Ticks * timestamp;
+        uint32_t deltaTime = (uint32_t)tick;
+        tickError = (tick - (double)deltaTime);
+        if(0x80 & message[0]){
+            if(message[0] < 0xF8){
+                runningStatus = (message[0] < 0xF0) ? message[0] : 0x00;
+            }
+            (void) writer.WriteEvent(deltaTime, message[0], message.data() + 1, size - 1);
+        }
+        else if(runningStatus){
+            (void) writer.WriteEvent(deltaTime, runningStatus, message.data(), size);
+        }
+        else{
+            // Data bytes without a preceding status byte are skipped, their delta time is added to the next message
+            tickError += (double)deltaTime;
+        }
+    }
+    (void) writer.WriteEvent(0, 0xFF, {0x2F, 0x00});                          // End of track
+    bool success = writer.EndTrack();
+    return writer.Close() && success;
+}
+
+void RecordingJournal::Write(void){
+    size_t numWritten = 0;
+    std::unique_lock<std::mutex> lock(mtx);
+    for(;;){
+        // Records that are published before the writer is stopped are written as well
+        bool stop = !running;
+        lock.unlock();
+        for(size_t numRecords = log->GetSize(); numWritten < numRecords; numWritten++){
+            const MIDIRecordLog::Record& record = log->Get(numWritten);
+            if((buffer.size() + sizeof(double) + sizeof(uint32_t) + record.length) > RECORDING_JOURNAL_BUFFER_SIZE){
+                Flush();
+            }
+            const uint8_t* timestamp = (const uint8_t*)&record.timestamp;
+            const uint8_t* length = (const uint8_t*)&record.length;
+            buffer.insert(buffer.end(), timestamp, timestamp + sizeof(double));
+            buffer.insert(buffer.end(), length, length + sizeof(uint32_t));
+            for(uint32_t i = 0; i < record.length; i++){
+                buffer.push_back(log->GetByte(record, i));
+            }
+        }
+        log->Consume(numWritten);
+        Flush();
+        lock.lock();
+        if(stop){
+            break;
+        }
+        cv.wait_for(lock, std::chrono::milliseconds(RECORDING_JOURNAL_FLUSH_PERIOD), [this](){ return !running; });
+    }
+}
+
+void RecordingJournal::Flush(void){
+    if(buffer.size()){
+        file.write((const char*)buffer.data(), buffer.size());
+        file.flush();
+        buffer.clear();
+    }
+}
+
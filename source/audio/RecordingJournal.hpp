@@ -0,0 +1,86 @@
+#pragma once
+
+
+#include <MIDIRecordLog.hpp>
+
+
+#define RECORDING_JOURNAL_BUFFER_SIZE      (65536)   ///< Size of the write buffer in bytes.
+#define RECORDING_JOURNAL_FLUSH_PERIOD     (100)     ///< Period in milliseconds in which new records are written to the journal.
+#define RECORDING_JOURNAL_MAX_RECORD_SIZE  (1 << 24) ///< Maximum number of message bytes of a journal record, longer records are treated as corrupted.
+
+
+/**
+ *  @brief Class: RecordingJournal
+ *  @details Appends the records of a @ref MIDIRecordLog continuously to a journal file while recording. A writer thread reads the published
+ *  records concurrently to the MIDI thread, writes them in batches through a fixed buffer and releases them, so that the record log can reuse their slots. The journal starts with an 8-byte header
+ *  ("CKRJ", closed flag, 3 reserved bytes) followed by records (delta time as double, length as uint32, message bytes) in native byte order.
+ *  The closed flag is set when the journal is closed regularly, a journal that is not closed is the result of a crash and can be recovered.
+ */
+class RecordingJournal {
+    public:
+        /**
+         *  @brief Create a recording journal.
+         */
+        RecordingJournal();
+
+        /**
+         *  @brief Close the recording journal.
+         */
+        ~RecordingJournal();
+
+        /**
+         *  @brief Create a new journal file and start the writer thread.
+         *  @param [in] filename The filename of the journal, an existing file is overwritten.
+         *  @param [in] log The record log to be written, the writer thread is its only consumer. It must not be cleared until the journal is closed.
+         *  @return True if success, false otherwise.
+         */
+        bool Open(std::string filename, MIDIRecordLog* log);
+
+        /**
+         *  @brief Stop the writer thread after all published records have been written, set the closed flag and close the journal file.
+         *  @details The producer of the record log must not be active anymore.
+         */
+        void Close(void);
+
+        /**
+         *  @brief Check whether a journal file exists that has not been closed regularly.
+         *  @param [in] filename The filename of the journal.
+         *  @return True if the journal exists and its closed flag is not set, false otherwise.
+         */
+        static bool IsUnfinished(std::string filename);
+
+        /**
+         *  @brief Set the closed flag of a journal file.
+         *  @param [in] filename The filename of the journal.
+         *  @return True if success, false otherwise.
+         */
+        static bool MarkClosed(std::string filename);
+
+        /**
+         *  @brief Convert a journal file to a standard MIDI file by streaming the records.
+         *  @param [in] journalFilename The filename of the journal. A truncated last record of an unfinished journal is ignored.
+         *  @param [in] midiFilename The filename of the MIDI file to be written.
+         *  @return True if success, false otherwise.
+         */
+        static bool Finalize(std::string journalFilename, std::string midiFilename);
+
+    private:
+        std::ofstream file;                 ///< The journal file stream.
+        MIDIRecordLog* log;                 ///< The record log to be written.
+        std::vector<uint8_t> buffer;        ///< Write buffer.
+        std::thread writer;                 ///< Writer thread.
+        std::mutex mtx;                     ///< Protects @ref running.
+        std::condition_variable cv;         ///< Wakes up the writer thread when it should stop.
+        bool running;                       ///< True while the writer thread should run.
+
+        /**
+         *  @brief Writer thread function.
+         */
+        void Write(void);
+
+        /**
+         *  @brief Write the content of the write buffer to the journal file and clear the buffer.
+         */
+        void Flush(void);
+};
+
@@ -0,0 +1,5 @@
+#include <RenderSnapshot.hpp>
+
+
+RenderSnapshot::RenderSnapshot(std::vector<float>&& mixdown, uint32_t numSamples): mixdown(std::move(mixdown)), numSamples(numSamples){}
+
@@ -0,0 +1,21 @@
+#pragma once
+
+
+/**
+ *  @brief Class: RenderSnapshot
+ *  @details Immutable audio data of a sequence that is handed over to the audio thread. A snapshot is published by
+ *  @ref AudioEngine::PublishSnapshot and is deleted by the audio engine as soon as the audio thread can no longer access it.
+ */
+class RenderSnapshot {
+    public:
+        const std::vector<float> mixdown;   ///< Pre-mixed samples of all tracks (empty in streaming mode).
+        const uint32_t numSamples;          ///< Length of the stereo sample buffer of the whole sequence (number of all floats).
+
+        /**
+         *  @brief Create a render snapshot.
+         *  @param [in] mixdown Pre-mixed samples of all tracks, the content is moved into the snapshot.
+         *  @param [in] numSamples Length of the stereo sample buffer of the whole sequence (number of all floats).
+         */
+        RenderSnapshot(std::vector<float>&& mixdown, uint32_t numSamples);
+};
+
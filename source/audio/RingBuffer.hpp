@@ -0,0 +1,95 @@
+#pragma once
+
+
+/**
+ *  @brief Class: RingBuffer
+ *  @details Lock-free single-producer/single-consumer ring buffer. Exactly one thread may call @ref Write and exactly one
+ *  other thread may call @ref Read. All other member functions must only be called while neither producer nor consumer is active.
+ */
+template <class T> class RingBuffer {
+    public:
+        /**
+         *  @brief Create an empty ring buffer.
+         */
+        RingBuffer():mask(0), head(0), tail(0){}
+
+        /**
+         *  @brief Resize the ring buffer and remove all elements.
+         *  @param [in] minCapacity Minimum number of elements that can be stored. The actual capacity is rounded up to the next power of two.
+         */
+        void Resize(size_t minCapacity){
+            size_t capacity = 1;
+            while(capacity < minCapacity){
+                capacity <<= 1;
+            }
+            buffer.assign(capacity, T());
+            mask = capacity - 1;
+            Clear();
+        }
+
+        /**
+         *  @brief Remove all elements.
+         */
+        void Clear(void){
+            head.store(0, std::memory_order_relaxed);
+            tail.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         *  @brief Get the capacity of the ring buffer.
+         *  @return Maximum number of elements that can be stored.
+         */
+        inline size_t GetCapacity(void) const { return buffer.size(); }
+
+        /**
+         *  @brief Get the number of elements that can be read.
+         *  @return Number of readable elements.
+         */
+        inline size_t GetNumReadable(void) const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+
+        /**
+         *  @brief Get the number of elements that can be written.
+         *  @return Number of writable elements.
+         */
+        inline size_t GetNumWritable(void) const { return buffer.size() - GetNumReadable(); }
+
+        /**
+         *  @brief Write elements to the ring buffer (producer only).
+         *  @param [in] data Elements to be written.
+         *  @param [in] num Number of elements to be written.
+         *  @return Number of elements that have actually been written.
+         */
+        size_t Write(const T* data, size_t num){
+            const size_t h = head.load(std::memory_order_relaxed);
+            const size_t t = tail.load(std::memory_order_acquire);
+            num = std::min(num, buffer.size() - (h - t));
+            for(size_t k = 0; k < num; k++){
+                buffer[(h + k) & mask] = data[k];
+            }
+            head.store(h + num, std::memory_order_release);
+            return num;
+        }
+
+        /**
+         *  @brief Read elements from the ring buffer (consumer only).
+         *  @param [out] data Destination for the elements that are read.
+         *  @param [in] num Maximum number of elements to be read.
+         *  @return Number of elements that have actually been read.
+         */
+        size_t Read(T* data, size_t num){
+            const size_t t = tail.load(std::memory_order_relaxed);
+            const size_t h = head.load(std::memory_order_acquire);
+            num = std::min(num, h - t);
+            for(size_t k = 0; k < num; k++){
+                data[k] = buffer[(t + k) & mask];
+            }
+            tail.store(t + num, std::memory_order_release);
+            return num;
+        }
+
+    private:
+        std::vector<T> buffer;       ///< Element storage, size is always a power of two.
+        size_t mask;                 ///< Index mask (capacity - 1).
+        std::atomic<size_t> head;    ///< Total number of elements written (only modified by producer).
+        std::atomic<size_t> tail;    ///< Total number of elements read (only modified by consumer).
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+
+/**
+ *  @brief Class: SeqLock
+ *  @details Sequence lock for a small trivially copyable value with exactly one writer. The writer never blocks and never waits.
+ *  Readers retry until they obtain a consistent copy, that is, no write happened while they were reading.
+ *  The value is stored in atomic words, so concurrent reads and writes are free of data races.
+ */
+template <class T> class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type!");
+
+    public:
+        /**
+         *  @brief Create a sequence lock with a value-initialized value.
+         */
+        SeqLock():sequence(0){
+            Store(T());
+        }
+
+        /**
+         *  @brief Store a new value (writer only).
+         *  @param [in] value The value to be stored.
+         */
+        void Store(const T& value){
+            std::array<uint64_t, NUM_WORDS> w;
+            w.fill(0);
+            std::memcpy(&w[0], &value, sizeof(T));
+            uint32_t s = sequence.load(std::memory_order_relaxed);
+            sequence.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for(size_t i = 0; i < NUM_WORDS; i++){
+                words[i].store(w[i], std::memory_order_relaxed);
+            }
+            sequence.store(s + 2, std::memory_order_release);
+        }
+
+        /**
+         *  @brief Load a consistent copy of the latest value.
+         *  @return The latest value that has been stored.
+         */
+        T Load(void) const {
+            std::array<uint64_t, NUM_WORDS> w;
+            uint32_t s0, s1;
+            do{
+                s0 = sequence.load(std::memory_order_acquire);
+                for(size_t i = 0; i < NUM_WORDS; i++){
+                    w[i] = words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                s1 = sequence.load(std::memory_order_relaxed);
+            } while((s0 & 1) || (s0 != s1));
+            T value;
+            std::memcpy(&value, &w[0], sizeof(T));
+            return value;
+        }
+
+    private:
+        static constexpr size_t NUM_WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+        std::atomic<uint32_t> sequence;                       ///< Sequence counter, odd while a write is in progress.
+        std::array<std::atomic<uint64_t>, NUM_WORDS> words;   ///< The stored value.
+};
+
@@ -5,6 +5,9 @@ SequenceTrack::SequenceTrack(uint8_t channel, std::string name){
     this->channel = channel;
     this->name = name;
     this->instrumentType = 0;
+    this->gain = 1.0f;
+    this->mute = false;
+    this->solo = false;
     this->colorWhiteKey = glm::u8vec3(145,222,64);
     this->colorBlackKey = glm::u8vec3(94,154,27);
 }
@@ -42,3 +45,103 @@ void SequenceTrack::SetColor(uint32_t value){
     }
 }
 
+void SequenceTrack::UpdateLaneIndex(void){
+    for(int k = 0; k < 88; k++){
+        laneMaxOff[k].resize(lanes[k].size());
+        double maxOff = -std::numeric_limits<double>::infinity();
+        for(size_t n = 0; n < lanes[k].size(); n++){
+            laneMaxOff[k][n] = (maxOff = std::max(maxOff, lanes[k][n].off));
+        }
+    }
+}
+
+void SequenceTrack::GetLaneRange(int key, double timeBegin, double timeEnd, size_t& first, size_t& last) const {
+    // Blocks before first end before the time window, blocks from last on start after the time window (lanes are sorted by on time)
+    const std::vector<NoteBlock>& lane = lanes[key];
+    const std::vector<double>& maxOff = laneMaxOff[key];
+    first = (size_t)(std::lower_bound(maxOff.begin(), maxOff.end(), timeBegin) - maxOff.begin());
+    last = (size_t)(std::upper_bound(lane.begin(), lane.end(), timeEnd, [](double t, const NoteBlock& noteBlock){ return t < noteBlock.on; }) - lane.begin());
+    last = std::max(first, std::min(last, maxOff.size()));
+}
+
+double SequenceTrack::GenerateLanes(const TempoMap& tempoMap, double timeScale){
+    // Remove all note blocks
+    for(int i = 0; i < 88; i++){
+        lanes[i].clear();
+    }
+
+    // Sustain pedal changes are swept in tick order along with the note events: nextPedalOff[k] is the index of the first pedal off event at index k or later
+    const std::vector<std::pair<uint64_t, bool>>& pedalChanges = sustainPedalChanges;
+    std::vector<size_t> nextPedalOff(pedalChanges.size() + 1, pedalChanges.size());
+    for(size_t k = pedalChanges.size(); k > 0; k--){
+        nextPedalOff[k - 1] = pedalChanges[k - 1].second ? nextPedalOff[k] : (k - 1);
+    }
+    size_t pedalIndex = 0; // Number of pedal changes up to the current tick
+    TempoMap::Cursor pedalCursor(tempoMap);
+    auto isPedalPressed = [&](uint64_t tick){
+        while((pedalIndex < pedalChanges.size()) && (pedalChanges[pedalIndex].first <= tick)){
+            pedalIndex++;
+        }
+        return pedalIndex && pedalChanges[pedalIndex - 1].second;
+    };
+    auto getTimestampOfNextPedalOff = [&](){
+        size_t k = nextPedalOff[pedalIndex];
+        return (k < pedalChanges.size()) ? pedalCursor.GetTimestamp(pedalChanges[k].first) : std::numeric_limits<double>::infinity();
+    };
+
+    // Process all midi events of this track (events are sorted by ticks, so tempo lookups can use a monotonic cursor)
+    TempoMap::Cursor tempoCursor(tempoMap);
+    double timeMax = 0.0;
+    std::array<size_t, 88> numClosedBlocks; // Number of note blocks at the beginning of each lane whose off time can no longer change
+    numClosedBlocks.fill(0);
+    for(auto&& me : midiEvents){
+        if((0x90 == (0XF0 & me.status)) && (2 == me.dataLength)){ // Note On
+            uint8_t key = me.inlineData[0];
+            uint8_t vel = me.inlineData[1] & 0x7F;
+            if((key < 21) || (key > 108)) // only keys between A0 and C8
+                continue;
+            key -= 21;
+            if(vel){ // Note On
+                double timeOn = timeScale * tempoCursor.GetTimestamp(me.absoluteTicks);
+                timeMax = std::max(timeMax, timeOn);
+                lanes[key].push_back(NoteBlock(double(vel) / 127.0, timeOn));
+            }
+            else{ // Note Off: Note On events with velocity zero are note off events
+                double timeOff = timeScale * tempoCursor.GetTimestamp(me.absoluteTicks);
+                timeMax = std::max(timeMax, timeOff);
+                if(lanes[key].size()){
+                    lanes[key].back().sustainOff = lanes[key].back().off = std::min(lanes[key].back().off, timeOff);
+                    if(isPedalPressed(me.absoluteTicks)){
+                        lanes[key].back().sustainOff = timeScale * getTimestampOfNextPedalOff();
+                    }
+                }
+                // Remove possible missing or too large note off events from previous notes (off times are non-decreasing, so only blocks since the last note off can change)
+                for(size_t n = numClosedBlocks[key]; n < lanes[key].size(); n++){
+                    lanes[key][n].off = std::min(lanes[key][n].off, timeOff);
+                }
+                numClosedBlocks[key] = lanes[key].size();
+            }
+        }
+        else if((0x80 == (0xF0 & me.status)) && (2 == me.dataLength)){ // Note Off
+            uint8_t key = me.inlineData[0];
+            if((key < 21) || (key > 108)) // only keys between A0 and C8
+                continue;
+            key -= 21;
+            double timeOff = timeScale * tempoCursor.GetTimestamp(me.absoluteTicks);
+            timeMax = std::max(timeMax, timeOff);
+            if(lanes[key].size()){
+                lanes[key].back().sustainOff = lanes[key].back().off = std::min(lanes[key].back().off, timeOff);
+                if(isPedalPressed(me.absoluteTicks)){
+                    lanes[key].back().sustainOff = timeScale * getTimestampOfNextPedalOff();
+                }
+            }
+            // Remove possible missing or too large note off events from previous notes (off times are non-decreasing, so only blocks since the last note off can change)
+            for(size_t n = numClosedBlocks[key]; n < lanes[key].size(); n++){
+                lanes[key][n].off = std::min(lanes[key][n].off, timeOff);
+            }
+            numClosedBlocks[key] = lanes[key].size();
+        }
+    }
+    return timeMax;
+}
+
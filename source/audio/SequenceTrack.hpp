@@ -3,6 +3,7 @@
 
 #include <MIDIEvent.hpp>
 #include <NoteBlock.hpp>
+#include <TempoMap.hpp>
 
 
 /* Forward declaration of friendly class */
@@ -18,6 +19,9 @@ class SequenceTrack {
         glm::u8vec3 colorWhiteKey;                    ///< Display color for white keys.
         glm::u8vec3 colorBlackKey;                    ///< Display color for black keys.
         std::vector<float> samples;                   ///< Samples of a stereo sound for the whole track. Those values are calculated if this sequence track object is passed to the sound rendering function of the audio engine.
+        float gain;                                   ///< Linear gain that is applied when mixing the track, defaults to 1.
+        bool mute;                                    ///< True if the track is muted.
+        bool solo;                                    ///< True if the track is soloed. If at least one track is soloed, only soloed tracks are audible.
 
         /**
          *  @brief Create a sequence track.
@@ -32,9 +36,35 @@ class SequenceTrack {
          */
         void SetColor(uint32_t value);
 
+        /**
+         *  @brief Generate the note blocks of all @ref lanes from the note events and sustain pedal changes of this track.
+         *  @param [in] tempoMap The tempo map that converts ticks to seconds.
+         *  @param [in] timeScale Scale factor for all times (inverse tempo scale).
+         *  @return The latest on or off time of all note events in seconds. Blocks without a note off event keep an infinite off time.
+         *  @details Missing or too late note off events are clamped to the next note off event of the same key.
+         */
+        double GenerateLanes(const TempoMap& tempoMap, double timeScale);
+
+        /**
+         *  @brief Update the time index of all @ref lanes. Call this function whenever the note blocks have been changed.
+         */
+        void UpdateLaneIndex(void);
+
+        /**
+         *  @brief Get the range of note blocks of a lane that may overlap a time window.
+         *  @param [in] key Index of the lane.
+         *  @param [in] timeBegin Begin of the time window in seconds.
+         *  @param [in] timeEnd End of the time window in seconds.
+         *  @param [out] first Index of the first note block that may overlap the time window.
+         *  @param [out] last Index after the last note block that may overlap the time window.
+         *  @details Uses a binary search on the time index (see @ref UpdateLaneIndex). Blocks inside the range may still lie outside the time window.
+         */
+        void GetLaneRange(int key, double timeBegin, double timeEnd, size_t& first, size_t& last) const;
+
     protected:
         friend Sequencer;
         std::vector<MIDIEvent> midiEvents;                           ///< MIDI events containing only note on/off events.
         std::vector<std::pair<uint64_t, bool>> sustainPedalChanges;  ///< Sustain pedal changes. First: absolute ticks, second: pedal pressed or not.
+        std::array<std::vector<double>, 88> laneMaxOff;              ///< Time index of all lanes: laneMaxOff[k][n] is the maximum off time of the note blocks 0 to n of lane k.
 };
 
@@ -2,6 +2,7 @@
 
 
 #include <SequenceTrack.hpp>
+#include <TempoMap.hpp>
 
 
 #define SEQUENCER_TEMPO_SCALE_MIN    (0.5)
@@ -13,8 +14,7 @@ class Sequencer {
         std::string name;                        ///< Name of the sequence (is set when @ref ReadMIDIFile is called).
         std::vector<SequenceTrack> tracks;       ///< List of all sequence tracks.
 
-        /* Audio streaming attributes */
-        uint32_t currentSample;                  ///< The current sample index of the streaming buffer. This value is used by the audio engine. NOTE: This is the index to a stereo sample buffer (0,2,4,.. indicate left samples, 1,3,5,.. indicate right samples).
+        /* Audio attributes */
         uint32_t maxNumSamples;                  ///< The greatest number of samples of all @ref tracks. This value is set by the @ref Generate member function. NOTE: This is the length of stereo sample buffer (number of all floats).
 
         /**
@@ -33,34 +33,28 @@ class Sequencer {
         /**
          *  @brief Generate or re-generate all sequence @ref tracks from the last MIDI file read and also (re-)generate audio samples.
          *  @param [in] tempoScale Scaling for tempo of the whole sequence in range [SEQUENCER_TEMPO_SCALE_MIN, SEQUENCER_TEMPO_SCALE_MAX].
+         *  @param [in] publish True if the result should be mixed and published to the audio engine by @ref Mix, false otherwise.
          */
-        void Generate(double tempoScale = 1.0);
-
-    private:
-        uint32_t ticksPerQuarter;                              ///< Number of ticks per quarter note.
-        std::vector<std::pair<uint64_t, double>> tempoChanges; ///< Absolute ticks where tempo changes occur (seconds per quarter note).
+        void Generate(double tempoScale = 1.0, bool publish = true);
 
         /**
-         *  @brief Convert a tick value to a timestamp in seconds.
-         *  @param [in] tick Absolute tick value of a MIDI event.
-         *  @return Corresponding absolute timestamp in seconds.
+         *  @brief Mix the samples of all @ref tracks and publish the result to the audio engine.
+         *  @details Applies the gain, mute and solo settings of all tracks. Call this function after changing those settings.
+         *  The result is handed over as a new render snapshot, so this function may also be called while the audio stream is playing.
+         *  In pre-render mode the samples of all tracks are kept to be able to mix again, so the peak memory is about the size of all track
+         *  samples plus one mixdown. The previous snapshot is released first if the stream is stopped, otherwise a second mixdown exists
+         *  until the new snapshot has been published.
          */
-        double GetTimestamp(uint64_t tick);
+        void Mix(void);
 
         /**
-         *  @brief Get the state of the sustain pedal for the current absolute tick value.
-         *  @param [in] tick Absolute tick value at which to query the pedal state.
-         *  @param [in] sustainPedalChanges Vector of pedal state changes.
-         *  @return True if pedal is pressed at query tick, false otherwise.
+         *  @brief Mix the samples of all @ref tracks without publishing the result.
+         *  @param [out] mixdown The stereo sample buffer of the whole sequence, is resized to @ref maxNumSamples.
+         *  @details Applies the gain, mute and solo settings of all tracks. The samples must have been rendered, that is, streaming mode must be disabled during @ref Generate.
          */
-        bool GetPedalState(uint64_t tick, std::vector<std::pair<uint64_t, bool>>& sustainPedalChanges);
+        void Mix(std::vector<float>& mixdown) const;
 
-        /**
-         *  @brief Get the timestamp of the next pedal off event.
-         *  @param [in] tick Absolute tick value from which to start the search.
-         *  @param [in] sustainPedalChanges Vector of pedal state changes.
-         *  @return Corresponnding absolute timestamp in seconds or INF if sustain pedal is never released.
-         */
-        double GetTimestampOfNextPedalOff(uint64_t tick, std::vector<std::pair<uint64_t, bool>>& sustainPedalChanges);
+    private:
+        TempoMap tempoMap;   ///< Tempo map of the last MIDI file read.
 };
 
@@ -0,0 +1,52 @@
+#include <TempoMap.hpp>
+
+
+TempoMap::Cursor::Cursor(const TempoMap& tempoMap){
+    this->tempoMap = &tempoMap;
+    this->index = 0;
+}
+
+double TempoMap::Cursor::GetTimestamp(uint64_t tick){
+    if(!tick) return 0.0;
+    const std::vector<uint64_t>& ticks = tempoMap->ticks;
+    if(ticks[index] >= tick){
+        // Moved backwards: restart with a binary search
+        index = (size_t)(std::lower_bound(ticks.begin(), ticks.end(), tick) - ticks.begin()) - 1;
+    }
+    while(((index + 1) < ticks.size()) && (ticks[index + 1] < tick)){
+        index++;
+    }
+    return tempoMap->GetTimestamp(tick, index);
+}
+
+TempoMap::TempoMap(){
+    Set({{0, 0.5}}, 1);
+}
+
+void TempoMap::Set(const std::vector<std::pair<uint64_t, double>>& tempoChanges, uint32_t ticksPerQuarter){
+    ticks.clear();
+    secondsPerTick.clear();
+    seconds.clear();
+    double tickDuration = 1.0 / double(std::max(1u, ticksPerQuarter));
+    if(tempoChanges.empty() || tempoChanges[0].first){
+        // 120 BPM as default tempo
+        ticks.push_back(0);
+        secondsPerTick.push_back(tickDuration * 0.5);
+        seconds.push_back(0.0);
+    }
+
+    // Accumulate the elapsed time up to each tempo change
+    for(auto&& tempoChange : tempoChanges){
+        seconds.push_back(seconds.empty() ? 0.0 : GetTimestamp(tempoChange.first, seconds.size() - 1));
+        ticks.push_back(tempoChange.first);
+        secondsPerTick.push_back(tickDuration * tempoChange.second);
+    }
+}
+
+double TempoMap::GetTimestamp(uint64_t tick) const {
+    if(!tick) return 0.0;
+    // Latest tempo change before the tick value (the first tempo change is always at tick 0)
+    size_t index = (size_t)(std::lower_bound(ticks.begin(), ticks.end(), tick) - ticks.begin()) - 1;
+    return GetTimestamp(tick, index);
+}
+
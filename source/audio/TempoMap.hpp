@@ -0,0 +1,67 @@
+#pragma once
+
+
+/**
+ *  @brief Class: TempoMap
+ *  @details Converts absolute MIDI ticks to seconds. The elapsed time at each tempo change is precomputed, so a single
+ *  conversion is a binary search. A @ref TempoMap::Cursor converts monotonically increasing ticks in amortized constant time.
+ */
+class TempoMap {
+    public:
+        /**
+         *  @brief Class: TempoMap::Cursor
+         *  @details Remembers the tempo segment of the previous query. Ticks should be queried in non-decreasing order, otherwise the cursor falls back to a binary search.
+         */
+        class Cursor {
+            public:
+                /**
+                 *  @brief Create a cursor at the beginning of a tempo map.
+                 *  @param [in] tempoMap The tempo map. It must not be changed while the cursor is in use.
+                 */
+                explicit Cursor(const TempoMap& tempoMap);
+
+                /**
+                 *  @brief Convert a tick value to a timestamp in seconds.
+                 *  @param [in] tick Absolute tick value, should not be less than the tick value of the previous query.
+                 *  @return Corresponding absolute timestamp in seconds.
+                 */
+                double GetTimestamp(uint64_t tick);
+
+            private:
+                const TempoMap* tempoMap;   ///< The tempo map to be used.
+                size_t index;               ///< Index of the tempo change of the previous query.
+        };
+
+        /**
+         *  @brief Create a tempo map with a constant tempo of 120 BPM.
+         */
+        TempoMap();
+
+        /**
+         *  @brief Set the tempo changes.
+         *  @param [in] tempoChanges Absolute ticks where tempo changes occur (seconds per quarter note), sorted by ticks. The first tempo change must be at tick 0.
+         *  @param [in] ticksPerQuarter Number of ticks per quarter note.
+         */
+        void Set(const std::vector<std::pair<uint64_t, double>>& tempoChanges, uint32_t ticksPerQuarter);
+
+        /**
+         *  @brief Convert a tick value to a timestamp in seconds.
+         *  @param [in] tick Absolute tick value.
+         *  @return Corresponding absolute timestamp in seconds.
+         */
+        double GetTimestamp(uint64_t tick) const;
+
+    private:
+        std::vector<uint64_t> ticks;              ///< Absolute ticks of all tempo changes (the first one is always 0).
+        std::vector<double> secondsPerTick;       ///< Tempo in seconds per tick that is valid from the corresponding tick value on.
+        std::vector<double> seconds;              ///< Absolute time in seconds of all tempo changes.
+
+        /**
+         *  @brief Convert a tick value to a timestamp in seconds using a given tempo segment.
+         *  @param [in] tick Absolute tick value.
+         *  @param [in] index Index of the latest tempo change before the tick value.
+         *  @return Corresponding absolute timestamp in seconds.
+         */
+        inline double GetTimestamp(uint64_t tick, size_t index) const { return seconds[index] + double(tick - ticks[index]) * secondsPerTick[index]; }
+};
+
@@ -0,0 +1,120 @@
+#include <WaveFileWriter.hpp>
+
+
+WaveFileWriter::WaveFileWriter(){
+    sampleRate = 0;
+    numChannels = 0;
+    numBytes = 0;
+    overflow = false;
+}
+
+WaveFileWriter::~WaveFileWriter(){
+    (void) Close();
+}
+
+bool WaveFileWriter::Open(std::string filename, uint32_t sampleRate, uint16_t numChannels){
+    (void) Close();
+    if(!sampleRate || !numChannels){
+        return false;
+    }
+    file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!file.is_open()){
+        LogError("Could not open file \"%s\"!\n", filename.c_str());
+        return false;
+    }
+    this->sampleRate = sampleRate;
+    this->numChannels = numChannels;
+    this->numBytes = 0;
+    this->overflow = false;
+    WriteHeader();
+    return file.good();
+}
+
+bool WaveFileWriter::Write(const float* samples, size_t num){
+    if(!file.is_open()){
+        return false;
+    }
+    if((uint64_t)(4 * num) > (WAVE_FILE_WRITER_MAX_DATA_SIZE - numBytes)){
+        if(!overflow){
+            LogError("Wave file exceeds the maximum size of %llu bytes of audio data!\n", (unsigned long long)WAVE_FILE_WRITER_MAX_DATA_SIZE);
+        }
+        overflow = true;
+        return false;
+    }
+
+    // Samples are stored in little endian byte order
+    uint8_t buffer[4 * 1024];
+    while(num){
+        size_t n = std::min(num, sizeof(buffer) / 4);
+        for(size_t k = 0; k < n; k++){
+            uint32_t u;
+            std::memcpy(&u, &samples[k], 4);
+            buffer[4*k] = (uint8_t)(u);
+            buffer[4*k + 1] = (uint8_t)(u >> 8);
+            buffer[4*k + 2] = (uint8_t)(u >> 16);
+            buffer[4*k + 3] = (uint8_t)(u >> 24);
+        }
+        file.write((char*)&buffer[0], 4 * n);
+        numBytes += 4 * n;
+        samples += n;
+        num -= n;
+    }
+    return file.good();
+}
+
+bool WaveFileWriter::Close(void){
+    if(!file.is_open()){
+        return false;
+    }
+    file.seekp(0, std::ios::beg);
+    WriteHeader();
+    bool success = file.good() && !overflow;
+    file.close();
+    return success;
+}
+
+bool WaveFileWriter::IsOpen(void){
+    return file.is_open();
+}
+
+void WaveFileWriter::WriteHeader(void){
+    // RIFF chunk sizes are limited to 32 bits, Write never exceeds the limit
+    const uint32_t dataSize = (uint32_t)numBytes;
+    const uint32_t blockAlign = 4 * (uint32_t)numChannels;
+    std::vector<uint8_t> header;
+    auto append = [&header](uint32_t value, int numBytes){
+        for(int i = 0; i < numBytes; i++){
+            header.push_back((uint8_t)(value >> (8 * i)));
+        }
+    };
+    auto appendTag = [&header](const char* tag){
+        header.insert(header.end(), tag, tag + 4);
+    };
+
+    // RIFF chunk
+    appendTag("RIFF");
+    append(50 + dataSize, 4);
+    appendTag("WAVE");
+
+    // Format chunk (IEEE float)
+    appendTag("fmt ");
+    append(18, 4);
+    append(3, 2);
+    append(numChannels, 2);
+    append(sampleRate, 4);
+    append(sampleRate * blockAlign, 4);
+    append(blockAlign, 2);
+    append(32, 2);
+    append(0, 2);
+
+    // Fact chunk (number of frames, required for non-PCM formats)
+    appendTag("fact");
+    append(4, 4);
+    append(dataSize / blockAlign, 4);
+
+    // Data chunk header, the samples follow
+    appendTag("data");
+    append(dataSize, 4);
+    file.write((char*)&header[0], header.size());
+}
+
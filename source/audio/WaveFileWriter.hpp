@@ -0,0 +1,65 @@
+#pragma once
+
+
+#define WAVE_FILE_WRITER_MAX_DATA_SIZE   (0xFFFFFFFFULL - 50)   ///< Maximum number of bytes of audio data, the RIFF chunk size (data and 50 header bytes) is limited to 32 bits.
+
+/**
+ *  @brief Class: WaveFileWriter
+ *  @details Writes interleaved 32-bit float samples to a WAVE file. Samples are appended block-wise, the chunk sizes
+ *  of the header are patched when the file is closed, so the length of the audio data does not have to be known in advance.
+ *  The audio data is limited to @ref WAVE_FILE_WRITER_MAX_DATA_SIZE bytes (about 3.1 hours of stereo at 48000 Hz), samples beyond that limit are rejected.
+ */
+class WaveFileWriter {
+    public:
+        /**
+         *  @brief Create a wave file writer.
+         */
+        WaveFileWriter();
+
+        /**
+         *  @brief Destroy the wave file writer and close the file.
+         */
+        ~WaveFileWriter();
+
+        /**
+         *  @brief Create a new wave file and write the header.
+         *  @param [in] filename The filename of the wave file, an existing file is overwritten.
+         *  @param [in] sampleRate Number of frames per second.
+         *  @param [in] numChannels Number of interleaved channels.
+         *  @return True if success, false otherwise.
+         */
+        bool Open(std::string filename, uint32_t sampleRate, uint16_t numChannels = 2);
+
+        /**
+         *  @brief Append interleaved samples to the wave file.
+         *  @param [in] samples Pointer to the samples.
+         *  @param [in] num Number of floats to be written (must be a multiple of the number of channels).
+         *  @return True if success, false otherwise. Nothing is written if the samples would exceed @ref WAVE_FILE_WRITER_MAX_DATA_SIZE.
+         */
+        bool Write(const float* samples, size_t num);
+
+        /**
+         *  @brief Patch the chunk sizes of the header and close the wave file.
+         *  @return True if success, false if an error occurred or samples have been rejected because of the size limit.
+         */
+        bool Close(void);
+
+        /**
+         *  @brief Check whether a wave file is open.
+         *  @return True if a wave file is open, false otherwise.
+         */
+        bool IsOpen(void);
+
+    private:
+        std::ofstream file;     ///< The output file stream.
+        uint32_t sampleRate;    ///< Number of frames per second.
+        uint16_t numChannels;   ///< Number of interleaved channels.
+        uint64_t numBytes;      ///< Number of bytes of audio data written so far.
+        bool overflow;          ///< True if samples have been rejected because of the size limit.
+
+        /**
+         *  @brief Write the RIFF header with the current chunk sizes to the current position of the file.
+         */
+        void WriteHeader(void);
+};
+
@@ -42,6 +42,10 @@ void Canvas::Render(GLFWwindow* wnd, double dt){
     renderer.RenderFrame(wnd, scene);
 }
 
+bool Canvas::IsAnimating(void){
+    return scene.IsAnimating();
+}
+
 void Canvas::Resize(GLFWwindow* wnd, int width, int height){
     scene.Resize(wnd, width, height);
     renderer.Resize(wnd, width, height);
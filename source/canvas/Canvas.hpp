@@ -30,6 +30,12 @@ class Canvas {
          */
         void Render(GLFWwindow* wnd, double dt);
 
+        /**
+         *  @brief Check whether the canvas has to be rendered continuously.
+         *  @return True if the content changes without user input (e.g. during playback), false otherwise.
+         */
+        bool IsAnimating(void);
+
         /**
          *  @brief Resize the canvas.
          *  @param [in] wnd GLFW window.
@@ -0,0 +1,151 @@
+#include <FrameProfiler.hpp>
+
+
+bool FrameProfiler::enabled = false;
+uint32_t FrameProfiler::frameIndex = 0;
+std::array<std::chrono::time_point<std::chrono::steady_clock>, FRAME_STAGE_COUNT> FrameProfiler::cpuBegin;
+std::array<float, FRAME_STAGE_COUNT> FrameProfiler::cpuTime;
+std::array<std::array<float, FRAME_PROFILER_HISTORY_SIZE>, FRAME_STAGE_COUNT> FrameProfiler::cpuHistory;
+std::array<std::array<float, FRAME_PROFILER_HISTORY_SIZE>, FRAME_STAGE_COUNT> FrameProfiler::gpuHistory;
+uint32_t FrameProfiler::gpuFrameIndex = 0;
+std::array<std::array<GLuint, 2 * FRAME_STAGE_COUNT>, FRAME_PROFILER_QUERY_LATENCY> FrameProfiler::queries;
+std::array<std::array<bool, FRAME_STAGE_COUNT>, FRAME_PROFILER_QUERY_LATENCY> FrameProfiler::issued;
+uint32_t FrameProfiler::numVisibleNoteBlocks = 0;
+uint32_t FrameProfiler::numCulledNoteBlocks = 0;
+
+
+void FrameProfiler::Terminate(void){
+    enabled = false;
+    if(queries[0][0]){
+        for(auto&& q : queries){
+            glDeleteQueries((GLsizei)q.size(), &q[0]);
+            q.fill(0);
+        }
+    }
+}
+
+void FrameProfiler::SetEnabled(bool enable){
+    if(enable && !queries[0][0]){
+        for(auto&& q : queries){
+            DEBUG_GLCHECK( glGenQueries((GLsizei)q.size(), &q[0]); );
+        }
+    }
+    if(enable && !enabled){
+        for(auto&& h : cpuHistory) h.fill(0.0f);
+        for(auto&& h : gpuHistory) h.fill(0.0f);
+        for(auto&& i : issued) i.fill(false);
+        cpuTime.fill(0.0f);
+        frameIndex = 0;
+        gpuFrameIndex = 0;
+    }
+    enabled = enable;
+}
+
+void FrameProfiler::BeginStage(FrameStage stage){
+    if(!enabled){
+        return;
+    }
+    if(FRAME_STAGE_SWAP != stage){
+        uint32_t slot = frameIndex % FRAME_PROFILER_QUERY_LATENCY;
+        DEBUG_GLCHECK( glQueryCounter(queries[slot][2 * stage], GL_TIMESTAMP); );
+    }
+    cpuBegin[stage] = std::chrono::steady_clock::now();
+}
+
+void FrameProfiler::EndStage(FrameStage stage){
+    if(!enabled){
+        return;
+    }
+    cpuTime[stage] += 1e-6f * (float)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - cpuBegin[stage]).count();
+    if(FRAME_STAGE_SWAP != stage){
+        uint32_t slot = frameIndex % FRAME_PROFILER_QUERY_LATENCY;
+        DEBUG_GLCHECK( glQueryCounter(queries[slot][2 * stage + 1], GL_TIMESTAMP); );
+        issued[slot][stage] = true;
+    }
+}
+
+void FrameProfiler::SetNoteBlockCount(uint32_t numVisible, uint32_t numCulled){
+    numVisibleNoteBlocks = numVisible;
+    numCulledNoteBlocks = numCulled;
+}
+
+void FrameProfiler::EndFrame(void){
+    if(!enabled){
+        return;
+    }
+
+    // CPU times of the current frame
+    uint32_t idx = frameIndex % FRAME_PROFILER_HISTORY_SIZE;
+    for(int s = 0; s < FRAME_STAGE_COUNT; s++){
+        cpuHistory[s][idx] = cpuTime[s];
+    }
+    cpuTime.fill(0.0f);
+
+    // GPU times of the oldest frame in flight, the frame is skipped (neither written to the history nor counted) if the results are not yet available
+    frameIndex++;
+    if(frameIndex < FRAME_PROFILER_QUERY_LATENCY){
+        return;
+    }
+    uint32_t slot = frameIndex % FRAME_PROFILER_QUERY_LATENCY;
+    GLuint available = GL_TRUE;
+    for(int s = 0; (s < FRAME_STAGE_COUNT) && available; s++){
+        if(issued[slot][s]){
+            DEBUG_GLCHECK( glGetQueryObjectuiv(queries[slot][2 * s + 1], GL_QUERY_RESULT_AVAILABLE, &available); );
+        }
+    }
+    if(available){
+        uint32_t gpuIdx = gpuFrameIndex % FRAME_PROFILER_HISTORY_SIZE;
+        for(int s = 0; s < FRAME_STAGE_COUNT; s++){
+            float t = 0.0f;
+            if(issued[slot][s]){
+                GLuint64 t0 = 0, t1 = 0;
+                DEBUG_GLCHECK( glGetQueryObjectui64v(queries[slot][2 * s], GL_QUERY_RESULT, &t0); );
+                DEBUG_GLCHECK( glGetQueryObjectui64v(queries[slot][2 * s + 1], GL_QUERY_RESULT, &t1); );
+                t = (t1 > t0) ? (1e-6f * (float)(t1 - t0)) : 0.0f;
+            }
+            gpuHistory[s][gpuIdx] = t;
+        }
+        gpuFrameIndex++;
+    }
+    issued[slot].fill(false);
+}
+
+void FrameProfiler::GetHistory(FrameStage stage, bool gpu, std::vector<float>& values){
+    const std::array<float, FRAME_PROFILER_HISTORY_SIZE>& history = gpu ? gpuHistory[stage] : cpuHistory[stage];
+    uint32_t start = (gpu ? gpuFrameIndex : frameIndex) % FRAME_PROFILER_HISTORY_SIZE;
+    values.resize(FRAME_PROFILER_HISTORY_SIZE);
+    for(uint32_t k = 0; k < FRAME_PROFILER_HISTORY_SIZE; k++){
+        values[k] = history[(start + k) % FRAME_PROFILER_HISTORY_SIZE];
+    }
+}
+
+float FrameProfiler::GetAverage(FrameStage stage, bool gpu){
+    const std::array<float, FRAME_PROFILER_HISTORY_SIZE>& history = gpu ? gpuHistory[stage] : cpuHistory[stage];
+    uint32_t n = std::min((uint32_t)FRAME_PROFILER_HISTORY_SIZE, gpu ? gpuFrameIndex : frameIndex);
+    if(!n){
+        return 0.0f;
+    }
+    float sum = 0.0f;
+    for(auto&& t : history){
+        sum += t;
+    }
+    return sum / (float)n;
+}
+
+void FrameProfiler::GetNoteBlockCount(uint32_t& numVisible, uint32_t& numCulled){
+    numVisible = numVisibleNoteBlocks;
+    numCulled = numCulledNoteBlocks;
+}
+
+const char* FrameProfiler::GetStageName(FrameStage stage){
+    switch(stage){
+        case FRAME_STAGE_SCENE_DRAW: return "Scene::Draw";
+        case FRAME_STAGE_NOTE_BLOCKS: return "Note blocks";
+        case FRAME_STAGE_NVG_END_FRAME: return "nvgEndFrame";
+        case FRAME_STAGE_POST_PROCESSING: return "Post-processing";
+        case FRAME_STAGE_SWAP: return "Swap";
+        case FRAME_STAGE_COUNT: break;
+    }
+    return "";
+}
+
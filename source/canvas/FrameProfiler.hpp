@@ -0,0 +1,110 @@
+#pragma once
+
+
+#define FRAME_PROFILER_HISTORY_SIZE      (240)   ///< Number of frames that are kept in the rolling history.
+#define FRAME_PROFILER_QUERY_LATENCY     (4)     ///< Number of frames after which the GPU timer queries of a frame are read back.
+
+
+enum FrameStage {
+    FRAME_STAGE_SCENE_DRAW,
+    FRAME_STAGE_NOTE_BLOCKS,
+    FRAME_STAGE_NVG_END_FRAME,
+    FRAME_STAGE_POST_PROCESSING,
+    FRAME_STAGE_SWAP,
+    FRAME_STAGE_COUNT
+};
+
+
+/**
+ *  @brief Class: FrameProfiler
+ *  @details Measures CPU and GPU times of the stages of a frame. Stages may be nested. GPU times are measured with timestamp
+ *  queries that are read back a few frames later without stalling the pipeline. Nothing is measured while the profiler is disabled.
+ */
+class FrameProfiler {
+    public:
+        /**
+         *  @brief Delete all GPU timer queries.
+         */
+        static void Terminate(void);
+
+        /**
+         *  @brief Enable or disable the profiler.
+         *  @param [in] enable True if frames should be profiled, false otherwise.
+         *  @details The GPU timer queries are generated when the profiler is enabled for the first time.
+         */
+        static void SetEnabled(bool enable);
+
+        /**
+         *  @brief Check whether the profiler is enabled.
+         *  @return True if the profiler is enabled, false otherwise.
+         */
+        static inline bool IsEnabled(void){ return enabled; }
+
+        /**
+         *  @brief Begin a stage of the current frame.
+         *  @param [in] stage The stage to begin.
+         */
+        static void BeginStage(FrameStage stage);
+
+        /**
+         *  @brief End a stage of the current frame.
+         *  @param [in] stage The stage to end.
+         */
+        static void EndStage(FrameStage stage);
+
+        /**
+         *  @brief Set the number of note blocks of the current frame.
+         *  @param [in] numVisible Number of note blocks that have been drawn.
+         *  @param [in] numCulled Number of note blocks that have been culled.
+         */
+        static void SetNoteBlockCount(uint32_t numVisible, uint32_t numCulled);
+
+        /**
+         *  @brief End the current frame and read back the GPU times of previous frames.
+         */
+        static void EndFrame(void);
+
+        /**
+         *  @brief Get the rolling history of a stage.
+         *  @param [in] stage The stage.
+         *  @param [in] gpu True for GPU times, false for CPU times.
+         *  @param [out] values Times in milliseconds, oldest first. The size is set to @ref FRAME_PROFILER_HISTORY_SIZE.
+         */
+        static void GetHistory(FrameStage stage, bool gpu, std::vector<float>& values);
+
+        /**
+         *  @brief Get the average time of a stage over the rolling history.
+         *  @param [in] stage The stage.
+         *  @param [in] gpu True for GPU times, false for CPU times.
+         *  @return Average time in milliseconds.
+         */
+        static float GetAverage(FrameStage stage, bool gpu);
+
+        /**
+         *  @brief Get the number of note blocks of the latest frame.
+         *  @param [out] numVisible Number of note blocks that have been drawn.
+         *  @param [out] numCulled Number of note blocks that have been culled.
+         */
+        static void GetNoteBlockCount(uint32_t& numVisible, uint32_t& numCulled);
+
+        /**
+         *  @brief Get the name of a stage.
+         *  @param [in] stage The stage.
+         *  @return Name of the stage.
+         */
+        static const char* GetStageName(FrameStage stage);
+
+    private:
+        static bool enabled;                                                                            ///< True if frames are profiled.
+        static uint32_t frameIndex;                                                                     ///< Index of the current frame.
+        static std::array<std::chrono::time_point<std::chrono::steady_clock>, FRAME_STAGE_COUNT> cpuBegin; ///< CPU time at the beginning of a stage of the current frame.
+        static std::array<float, FRAME_STAGE_COUNT> cpuTime;                                            ///< CPU time of all stages of the current frame in milliseconds.
+        static std::array<std::array<float, FRAME_PROFILER_HISTORY_SIZE>, FRAME_STAGE_COUNT> cpuHistory; ///< Rolling history of CPU times in milliseconds.
+        static std::array<std::array<float, FRAME_PROFILER_HISTORY_SIZE>, FRAME_STAGE_COUNT> gpuHistory; ///< Rolling history of GPU times in milliseconds.
+        static uint32_t gpuFrameIndex;                                                                  ///< Number of frames whose GPU times have been read back.
+        static std::array<std::array<GLuint, 2 * FRAME_STAGE_COUNT>, FRAME_PROFILER_QUERY_LATENCY> queries; ///< Begin and end timestamp queries of all stages for each frame in flight.
+        static std::array<std::array<bool, FRAME_STAGE_COUNT>, FRAME_PROFILER_QUERY_LATENCY> issued;    ///< True if the timestamp queries of a stage have been issued.
+        static uint32_t numVisibleNoteBlocks;                                                           ///< Number of note blocks that have been drawn in the latest frame.
+        static uint32_t numCulledNoteBlocks;                                                            ///< Number of note blocks that have been culled in the latest frame.
+};
+
@@ -26,6 +26,7 @@ bool Renderer::Initialize(GLFWwindow* wnd){
 }
 
 void Renderer::Terminate(GLFWwindow* wnd){
+    FrameProfiler::Terminate();
     DeleteShaders();
     DeleteFrameBuffers();
     (void)wnd;
@@ -35,14 +36,18 @@ void Renderer::RenderFrame(GLFWwindow* wnd, Scene& scene){
     // Render Scene + GUI
     DEBUG_GLCHECK( glBindFramebuffer(GL_FRAMEBUFFER, fbGUI.fbo); );
     DEBUG_GLCHECK( glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT); );
+    FrameProfiler::BeginStage(FRAME_STAGE_SCENE_DRAW);
     scene.Draw(wnd);
+    FrameProfiler::EndStage(FRAME_STAGE_SCENE_DRAW);
     DEBUG_GLCHECK( glDisable(GL_BLEND); );
     DEBUG_GLCHECK( glDisable(GL_DEPTH_TEST); );
 
     // Post processing, render to default framebuffer (0)
+    FrameProfiler::BeginStage(FRAME_STAGE_POST_PROCESSING);
     DEBUG_GLCHECK( glBindFramebuffer(GL_FRAMEBUFFER, 0); );
     shaderPostProcessing.Use();
     MainWindow::DrawNormalizedRect();
+    FrameProfiler::EndStage(FRAME_STAGE_POST_PROCESSING);
     (void)wnd;
 }
 
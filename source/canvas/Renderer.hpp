@@ -4,6 +4,7 @@
 #include <FrameBufferGUI.hpp>
 #include <ShaderPostProcessing.hpp>
 #include <Scene.hpp>
+#include <FrameProfiler.hpp>
 
 
 class Renderer {
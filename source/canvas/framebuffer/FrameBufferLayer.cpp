@@ -0,0 +1,134 @@
+#include <FrameBufferLayer.hpp>
+
+
+FrameBufferLayer::FrameBufferLayer(){
+    this->cbo = 0;
+    this->rbo = 0;
+    this->fbo = 0;
+    this->image = 0;
+    this->ctx = nullptr;
+    this->width = 0;
+    this->height = 0;
+    this->position = glm::vec2(0.0f);
+    this->dimension = glm::vec2(0.0f);
+    this->previousFBO = 0;
+    for(int i = 0; i < 4; i++){
+        this->previousViewport[i] = 0;
+    }
+}
+
+FrameBufferLayer::~FrameBufferLayer(){}
+
+bool FrameBufferLayer::Generate(NVGcontext* vg, GLint width, GLint height){
+    Delete();
+    DEBUG_GLCHECK( glGenFramebuffers(1, &this->fbo); );
+    DEBUG_GLCHECK( glBindFramebuffer(GL_FRAMEBUFFER, this->fbo); );
+        // Colorbuffer
+        DEBUG_GLCHECK( glGenTextures(1, &this->cbo); );
+        DEBUG_GLCHECK( glActiveTexture(TEXTUREUNIT_DEFAULT); );
+        DEBUG_GLCHECK( glBindTexture(GL_TEXTURE_2D, this->cbo); );
+        DEBUG_GLCHECK( glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL); );
+        DEBUG_GLCHECK( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); );
+        DEBUG_GLCHECK( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); );
+        DEBUG_GLCHECK( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); );
+        DEBUG_GLCHECK( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); );
+        DEBUG_GLCHECK( glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->cbo, 0); );
+        // Rendering buffer for depth and stencil
+        DEBUG_GLCHECK( glGenRenderbuffers(1, &this->rbo); );
+        DEBUG_GLCHECK( glBindRenderbuffer(GL_RENDERBUFFER, this->rbo);  );
+        DEBUG_GLCHECK( glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height); );
+        DEBUG_GLCHECK( glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, this->rbo); );
+        // Check for completeness
+        if(GL_FRAMEBUFFER_COMPLETE != glCheckFramebufferStatus(GL_FRAMEBUFFER)){
+            DEBUG_GLCHECK( glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)previousFBO); );
+            Delete();
+            return false;
+        }
+    DEBUG_GLCHECK( glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)previousFBO); );
+
+    // The texture is owned by this layer, NanoVG only references it
+    this->image = nvglCreateImageFromHandleGL3(vg, this->cbo, width, height, NVG_IMAGE_FLIPY | NVG_IMAGE_PREMULTIPLIED | NVG_IMAGE_NODELETE);
+    if(!this->image){
+        Delete();
+        return false;
+    }
+    this->ctx = vg;
+    this->width = width;
+    this->height = height;
+    return true;
+}
+
+void FrameBufferLayer::Delete(void){
+    // Delete image handle
+    if(this->image && this->ctx){
+        nvgDeleteImage(this->ctx, this->image);
+    }
+    this->image = 0;
+    this->ctx = nullptr;
+    this->width = 0;
+    this->height = 0;
+
+    // Delete colorbuffers
+    if(this->cbo){
+        glDeleteTextures(1, &this->cbo);
+        this->cbo = 0;
+    }
+
+    // Delete renderbuffer
+    if(this->rbo){
+        glDeleteRenderbuffers(1, &this->rbo);
+        this->rbo = 0;
+    }
+
+    // Delete framebuffer
+    if(this->fbo){
+        glDeleteFramebuffers(1, &this->fbo);
+        this->fbo = 0;
+    }
+}
+
+bool FrameBufferLayer::Begin(NVGcontext* vg, glm::vec2 position, glm::vec2 dimension, float pxRatio){
+    // Align the layer area to framebuffer pixels, so that the layer is composited without resampling
+    glm::vec2 p0(std::floor(position.x * pxRatio), std::floor(position.y * pxRatio));
+    glm::vec2 p1(std::ceil((position.x + dimension.x) * pxRatio), std::ceil((position.y + dimension.y) * pxRatio));
+    GLint w = (GLint)(p1.x - p0.x);
+    GLint h = (GLint)(p1.y - p0.y);
+    if((w < 1) || (h < 1)){
+        Delete();
+        return false;
+    }
+    DEBUG_GLCHECK( glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO); );
+    DEBUG_GLCHECK( glGetIntegerv(GL_VIEWPORT, &previousViewport[0]); );
+    if((w != this->width) || (h != this->height) || (vg != this->ctx)){
+        if(!Generate(vg, w, h)){
+            return false;
+        }
+    }
+    this->position = p0 * (1.0f / pxRatio);
+    this->dimension = (p1 - p0) * (1.0f / pxRatio);
+
+    // Render into the layer, the origin of the window coordinates is moved to the layer position
+    DEBUG_GLCHECK( glBindFramebuffer(GL_FRAMEBUFFER, this->fbo); );
+    DEBUG_GLCHECK( glViewport(0, 0, w, h); );
+    DEBUG_GLCHECK( glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT); );
+    nvgBeginFrame(vg, this->dimension.x, this->dimension.y, pxRatio);
+    nvgTranslate(vg, -this->position.x, -this->position.y);
+    return true;
+}
+
+void FrameBufferLayer::End(NVGcontext* vg){
+    nvgEndFrame(vg);
+    DEBUG_GLCHECK( glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)previousFBO); );
+    DEBUG_GLCHECK( glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]); );
+}
+
+void FrameBufferLayer::Draw(NVGcontext* vg){
+    if(!this->image){
+        return;
+    }
+    nvgBeginPath(vg);
+    nvgRect(vg, position.x, position.y, dimension.x, dimension.y);
+    nvgFillPaint(vg, nvgImagePattern(vg, position.x, position.y, dimension.x, dimension.y, 0.0f, this->image, 1.0f));
+    nvgFill(vg);
+}
+
@@ -0,0 +1,76 @@
+#pragma once
+
+
+#include <nanovg/nanovg_gl.h>
+
+
+/**
+ *  @brief Class: FrameBufferLayer
+ *  @details Offscreen layer for static vector graphics. The content is rendered once between @ref Begin and @ref End and
+ *  is composited every frame by @ref Draw. The layer covers a rectangular area of the window that is aligned to framebuffer pixels.
+ */
+class FrameBufferLayer {
+    public:
+        GLuint cbo;  ///< Colorbuffer (RGBA).
+        GLuint rbo;  ///< Renderbuffer object (depth + stencil, required by NanoVG).
+        GLuint fbo;  ///< The actual framebuffer object.
+        int image;   ///< NanoVG image handle of the colorbuffer.
+
+        /**
+         *  @brief Create a framebuffer layer.
+         */
+        FrameBufferLayer();
+
+        /**
+         *  @brief Delete the framebuffer layer.
+         */
+        ~FrameBufferLayer();
+
+        /**
+         *  @brief Delete colorbuffer, renderbuffer, framebuffer object and the NanoVG image handle.
+         *  @details The NanoVG context that has been passed to @ref Begin must still be valid.
+         */
+        void Delete(void);
+
+        /**
+         *  @brief Begin rendering into the layer.
+         *  @param [in] vg Vector-graphic context. No frame must be in progress.
+         *  @param [in] position Position of the layer area in window pixels (y from top to bottom).
+         *  @param [in] dimension Dimension of the layer area in window pixels.
+         *  @param [in] pxRatio Ratio of framebuffer size to window size.
+         *  @return True if success, false otherwise. If true is returned, @ref End must be called.
+         *  @details The layer is (re-)generated if its size changes. A NanoVG frame is started and window coordinates can be used for drawing.
+         */
+        bool Begin(NVGcontext* vg, glm::vec2 position, glm::vec2 dimension, float pxRatio);
+
+        /**
+         *  @brief End rendering into the layer and restore the previous framebuffer and viewport.
+         *  @param [in] vg Vector-graphic context.
+         */
+        void End(NVGcontext* vg);
+
+        /**
+         *  @brief Composite the layer into the current NanoVG frame.
+         *  @param [in] vg Vector-graphic context.
+         */
+        void Draw(NVGcontext* vg);
+
+    private:
+        NVGcontext* ctx;               ///< The vector-graphic context that owns the image handle.
+        GLint width;                   ///< Width of the layer in framebuffer pixels.
+        GLint height;                  ///< Height of the layer in framebuffer pixels.
+        glm::vec2 position;            ///< Aligned position of the layer in window pixels.
+        glm::vec2 dimension;           ///< Aligned dimension of the layer in window pixels.
+        GLint previousFBO;             ///< Framebuffer that was bound when @ref Begin was called.
+        GLint previousViewport[4];     ///< Viewport that was set when @ref Begin was called.
+
+        /**
+         *  @brief Generate colorbuffer, renderbuffer, framebuffer and the NanoVG image handle.
+         *  @param [in] vg Vector-graphic context.
+         *  @param [in] width Width of the framebuffer in pixels.
+         *  @param [in] height Height of the framebuffer in pixels.
+         *  @return True if success, false otherwise.
+         */
+        bool Generate(NVGcontext* vg, GLint width, GLint height);
+};
+
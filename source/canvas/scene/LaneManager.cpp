@@ -5,8 +5,6 @@
 
 #define NOTE_BLOCK_RADIUS                 (0.004)  // Radius of note block with respect to width of lane manager.
 #define NOTE_BLOCK_EDGE                   (0.001)  // Edge size of note block with respect to width of lane manager.
-#define NOTE_BLOCK_COLOR_SCALE_EDGE       (0.25)   // Color scale for edge of note block.
-#define NOTE_BLOCK_COLOR_SCALE_GRADIENT   (1.4)    // Color scale for upper gradient color of note block color.
 
 
 LaneManager::LaneManager(){
@@ -19,15 +17,18 @@ LaneManager::LaneManager(){
     yCursorBegin = 0.0;
     timeBegin = 0.0;
     y0 = 0.0;
+    layerValid = false;
+    recorderCursors.fill(0);
+    recorderCutoff = 0.0;
 };
 
-void LaneManager::Draw(NVGcontext* vg, Sequencer& sequencer, double timePointer, MusicalKeyboard& keyboard){
-    // Reset keys of keyboard
-    for(int i = 0; i < 88; i++){
-        keyboard.keys[i].pressed = false;
+void LaneManager::UpdateLayer(NVGcontext* vg, float pxRatio){
+    if(layerValid){
+        return;
+    }
+    if(!layer.Begin(vg, position, dimension, pxRatio)){
+        return;
     }
-
-    // Background
     nvgBeginPath(vg);
     nvgRect(vg, position.x, position.y, dimension.x, dimension.y);
     nvgFillColor(vg, nvgRGBA(60,60,60,255));
@@ -44,83 +45,48 @@ void LaneManager::Draw(NVGcontext* vg, Sequencer& sequencer, double timePointer,
         nvgFillColor(vg, nvgRGBA(lanes[Key::idxBlack[i]].color.x, lanes[Key::idxBlack[i]].color.y, lanes[Key::idxBlack[i]].color.z, 180));
         nvgFill(vg);
     }
+    layer.End(vg);
+    layerValid = true;
+}
 
-    // Render sequencer data of selected tracks
-    nvgScissor(vg, position.x, position.y, dimension.x, dimension.y);
-    double pixelsPerSecond = this->dimension.y / this->timeHorizon;
-    float edgeSize2 = edgeSize + edgeSize;
-    for(int idxTrack = 0; idxTrack < (int)sequencer.tracks.size(); idxTrack++){
-        // White keys
-        for(int i = 0; i < 52; i++){
-            int k = Key::idxWhite[i];
-            for(auto&& noteBlock : sequencer.tracks[idxTrack].lanes[k]){
-                double y = (noteBlock.on - timePointer) * pixelsPerSecond;
-                double h = (noteBlock.off - noteBlock.on) * pixelsPerSecond;
-                y = position.y + dimension.y - y - h;
-
-                // Ignore note blocks out of lane area
-                if(((y < position.y) && ((y+h) < position.y)) || ((y > (position.y + dimension.y)) && ((y + h) > (position.y + dimension.y)))){
-                    continue;
-                }
+void LaneManager::DeleteLayer(void){
+    layer.Delete();
+    layerValid = false;
+}
 
-                // Draw the note block
-                nvgBeginPath(vg);
-                nvgRoundedRect(vg, this->lanes[k].x, (float)y, this->lanes[k].w, (float)h, noteRadius);
-                nvgFillColor(vg, nvgRGBA(uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(sequencer.tracks[idxTrack].colorWhiteKey.r)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(sequencer.tracks[idxTrack].colorWhiteKey.g)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(sequencer.tracks[idxTrack].colorWhiteKey.b)), 255));
-                nvgFill(vg);
-                nvgBeginPath(vg);
-                nvgRoundedRect(vg, this->lanes[k].x + edgeSize, (float)y + edgeSize, this->lanes[k].w - edgeSize2, (float)h - edgeSize2, noteRadius - edgeSize);
-                NVGcolor colorGradientBegin = nvgRGBA(uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(sequencer.tracks[idxTrack].colorWhiteKey.r), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(sequencer.tracks[idxTrack].colorWhiteKey.g), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(sequencer.tracks[idxTrack].colorWhiteKey.b),255.0)), 255);
-                NVGcolor colorGradientEnd = nvgRGBA(sequencer.tracks[idxTrack].colorWhiteKey.r, sequencer.tracks[idxTrack].colorWhiteKey.g, sequencer.tracks[idxTrack].colorWhiteKey.b, 255);
-                NVGpaint gradient = nvgLinearGradient(vg, this->lanes[k].x + edgeSize, 0.0f, this->lanes[k].x + this->lanes[k].w - edgeSize2, 0.0f, colorGradientBegin, colorGradientEnd);
-                nvgFillPaint(vg, gradient);
-                nvgFill(vg);
+void LaneManager::DrawBackground(NVGcontext* vg){
+    layer.Draw(vg);
+}
 
-                // Check if key is pressed
-                bool pressed = ((y + h) >= (double)(position.y + dimension.y));
-                keyboard.keys[k].pressed |= pressed;
-                if(pressed){
-                    keyboard.keys[k].color = sequencer.tracks[idxTrack].colorWhiteKey;
+void LaneManager::Draw(NoteBlockRenderer& noteBlockRenderer, Sequencer& sequencer, double timePointer, MusicalKeyboard& keyboard, glm::vec2 windowSize){
+    // Update keys of keyboard, only note blocks at the time pointer are visited
+    auto updateKey = [&](int k, bool black){
+        keyboard.keys[k].pressed = false;
+        for(auto&& track : sequencer.tracks){
+            size_t first, last;
+            track.GetLaneRange(k, timePointer, timePointer, first, last);
+            for(size_t n = first; n < last; n++){
+                const NoteBlock& noteBlock = track.lanes[k][n];
+                if((noteBlock.on <= timePointer) && (noteBlock.off >= timePointer)){
+                    keyboard.keys[k].pressed = true;
+                    keyboard.keys[k].color = black ? track.colorBlackKey : track.colorWhiteKey;
                 }
             }
         }
+    };
+    for(int i = 0; i < 52; i++){
+        updateKey(Key::idxWhite[i], false);
+    }
+    for(int i = 0; i < 36; i++){
+        updateKey(Key::idxBlack[i], true);
+    }
 
-        // Black keys
-        for(int i = 0; i < 36; i++){
-            int k = Key::idxBlack[i];
-            for(auto&& noteBlock : sequencer.tracks[idxTrack].lanes[k]){
-                double y = (noteBlock.on - timePointer) * pixelsPerSecond;
-                double h = (noteBlock.off - noteBlock.on) * pixelsPerSecond;
-                y = position.y + dimension.y - y - h;
-
-                // Ignore note blocks out of lane area
-                if(((y < position.y) && ((y+h) < position.y)) || ((y > (position.y + dimension.y)) && ((y + h) > (position.y + dimension.y)))){
-                    continue;
-                }
-
-                // Draw the note block
-                nvgBeginPath(vg);
-                nvgRoundedRect(vg, this->lanes[k].x, (float)y, this->lanes[k].w, (float)h, noteRadius);
-                nvgFillColor(vg, nvgRGBA(uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(sequencer.tracks[idxTrack].colorBlackKey.r)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(sequencer.tracks[idxTrack].colorBlackKey.g)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(sequencer.tracks[idxTrack].colorBlackKey.b)), 255));
-                nvgFill(vg);
-                nvgBeginPath(vg);
-                nvgRoundedRect(vg, this->lanes[k].x + edgeSize, (float)y + edgeSize, this->lanes[k].w - edgeSize2, (float)h - edgeSize2, noteRadius - edgeSize);
-                NVGcolor colorGradientBegin = nvgRGBA(uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(sequencer.tracks[idxTrack].colorBlackKey.r), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(sequencer.tracks[idxTrack].colorBlackKey.g), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(sequencer.tracks[idxTrack].colorBlackKey.b),255.0)), 255);
-                NVGcolor colorGradientEnd = nvgRGBA(sequencer.tracks[idxTrack].colorBlackKey.r, sequencer.tracks[idxTrack].colorBlackKey.g, sequencer.tracks[idxTrack].colorBlackKey.b, 255);
-                NVGpaint gradient = nvgLinearGradient(vg, this->lanes[k].x + edgeSize, 0.0f, this->lanes[k].x + this->lanes[k].w - edgeSize2, 0.0f, colorGradientBegin, colorGradientEnd);
-                nvgFillPaint(vg, gradient);
-                nvgFill(vg);
-
-                // Check if key is pressed
-                bool pressed = ((y + h) >= (double)(position.y + dimension.y));
-                keyboard.keys[k].pressed |= pressed;
-                if(pressed){
-                    keyboard.keys[k].color = sequencer.tracks[idxTrack].colorBlackKey;
-                }
-            }
-        }
+    // Render sequencer data of all tracks on the GPU
+    std::array<glm::vec2, 88> laneBounds;
+    for(int k = 0; k < 88; k++){
+        laneBounds[k] = glm::vec2((float)lanes[k].x, (float)lanes[k].w);
     }
-    nvgResetScissor(vg);
+    noteBlockRenderer.Draw(timePointer, timeHorizon, laneBounds, glm::vec4(position.x, position.y, dimension.x, dimension.y), windowSize, noteRadius, edgeSize);
 }
 
 void LaneManager::Draw(NVGcontext* vg, Recorder& recorder, MusicalKeyboard& keyboard){
@@ -130,22 +96,7 @@ void LaneManager::Draw(NVGcontext* vg, Recorder& recorder, MusicalKeyboard& keyb
     }
 
     // Background
-    nvgBeginPath(vg);
-    nvgRect(vg, position.x, position.y, dimension.x, dimension.y);
-    nvgFillColor(vg, nvgRGBA(60,60,60,255));
-    nvgFill(vg);
-    for(int i = 0; i < 52; i++){
-        nvgBeginPath(vg);
-        nvgRect(vg, lanes[Key::idxWhite[i]].x, position.y, lanes[Key::idxWhite[i]].w, dimension.y);
-        nvgFillColor(vg, nvgRGBA(lanes[Key::idxWhite[i]].color.x, lanes[Key::idxWhite[i]].color.y, lanes[Key::idxWhite[i]].color.z, 255));
-        nvgFill(vg);
-    }
-    for(int i = 0; i < 36; i++){
-        nvgBeginPath(vg);
-        nvgRect(vg, lanes[Key::idxBlack[i]].x, position.y, lanes[Key::idxBlack[i]].w, dimension.y);
-        nvgFillColor(vg, nvgRGBA(lanes[Key::idxBlack[i]].color.x, lanes[Key::idxBlack[i]].color.y, lanes[Key::idxBlack[i]].color.z, 180));
-        nvgFill(vg);
-    }
+    DrawBackground(vg);
 
     // Render recorder data
     nvgScissor(vg, position.x, position.y, dimension.x, dimension.y);
@@ -153,14 +104,34 @@ void LaneManager::Draw(NVGcontext* vg, Recorder& recorder, MusicalKeyboard& keyb
     float edgeSize2 = edgeSize + edgeSize;
     double timePointer = recorder.GetTimePointer();
 
-    // White keys
-    recorder.mtxTrack.lock();
+    // Advance the cursor of each lane past all notes that went off below the lane area, notes of a lane are ordered by their on time.
+    // The cursors are reset if the cutoff time decreases (new recording, larger time horizon or resize). Only the latest note of a lane
+    // can still be on (see NoteLog::Append), so a note without note off never holds back the cursor of its lane.
+    double cutoff = timePointer - (position.y + dimension.y - y0) / pixelsPerSecond;
+    if(!(cutoff >= recorderCutoff)){
+        recorderCursors.fill(0);
+    }
+    recorderCutoff = cutoff;
+    for(int k = 0; k < 88; k++){
+        size_t numNotes = recorder.notes.GetSize(k);
+        size_t& cursor = recorderCursors[k];
+        if(cursor > numNotes){
+            cursor = 0;
+        }
+        while((cursor < numNotes) && (recorder.notes.Get(k, cursor).off.load(std::memory_order_acquire) < cutoff)){
+            cursor++;
+        }
+    }
+
+    // White keys (the note log is read without blocking the MIDI thread)
     for(int i = 0; i < 52; i++){
         int k = Key::idxWhite[i];
-        for(auto&& noteBlock : recorder.track.lanes[k]){
-            double yon = y0 + (timePointer - noteBlock.on) * pixelsPerSecond;
-            double yoff = y0 + (timePointer - noteBlock.off) * pixelsPerSecond;
-            if(noteBlock.off > timePointer){
+        for(size_t n = recorderCursors[k], numNotes = recorder.notes.GetSize(k); n < numNotes; n++){
+            const NoteLog::Note& note = recorder.notes.Get(k, n);
+            double off = note.off.load(std::memory_order_acquire);
+            double yon = y0 + (timePointer - note.on) * pixelsPerSecond;
+            double yoff = y0 + (timePointer - off) * pixelsPerSecond;
+            if(off > timePointer){
                 yoff = -noteRadius - edgeSize;
             }
             double y = yoff;
@@ -174,12 +145,12 @@ void LaneManager::Draw(NVGcontext* vg, Recorder& recorder, MusicalKeyboard& keyb
             // Draw the note block
             nvgBeginPath(vg);
             nvgRoundedRect(vg, this->lanes[k].x, (float)y, this->lanes[k].w, (float)h, noteRadius);
-            nvgFillColor(vg, nvgRGBA(uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.track.colorWhiteKey.r)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.track.colorWhiteKey.g)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.track.colorWhiteKey.b)), 255));
+            nvgFillColor(vg, nvgRGBA(uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.colorWhiteKey.r)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.colorWhiteKey.g)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.colorWhiteKey.b)), 255));
             nvgFill(vg);
             nvgBeginPath(vg);
             nvgRoundedRect(vg, this->lanes[k].x + edgeSize, (float)y + edgeSize, this->lanes[k].w - edgeSize2, (float)h - edgeSize2, noteRadius - edgeSize);
-            NVGcolor colorGradientBegin = nvgRGBA(uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.track.colorWhiteKey.r), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.track.colorWhiteKey.g), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.track.colorWhiteKey.b),255.0)), 255);
-            NVGcolor colorGradientEnd = nvgRGBA(recorder.track.colorWhiteKey.r, recorder.track.colorWhiteKey.g, recorder.track.colorWhiteKey.b, 255);
+            NVGcolor colorGradientBegin = nvgRGBA(uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.colorWhiteKey.r), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.colorWhiteKey.g), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.colorWhiteKey.b),255.0)), 255);
+            NVGcolor colorGradientEnd = nvgRGBA(recorder.colorWhiteKey.r, recorder.colorWhiteKey.g, recorder.colorWhiteKey.b, 255);
             NVGpaint gradient = nvgLinearGradient(vg, this->lanes[k].x + edgeSize, 0.0f, this->lanes[k].x + this->lanes[k].w - edgeSize2, 0.0f, colorGradientBegin, colorGradientEnd);
             nvgFillPaint(vg, gradient);
             nvgFill(vg);
@@ -188,7 +159,7 @@ void LaneManager::Draw(NVGcontext* vg, Recorder& recorder, MusicalKeyboard& keyb
             bool pressed = yoff < 0.0;
             keyboard.keys[k].pressed |= pressed;
             if(pressed){
-                keyboard.keys[k].color = recorder.track.colorWhiteKey;
+                keyboard.keys[k].color = recorder.colorWhiteKey;
             }
         }
     }
@@ -196,10 +167,12 @@ void LaneManager::Draw(NVGcontext* vg, Recorder& recorder, MusicalKeyboard& keyb
     // Black keys
     for(int i = 0; i < 36; i++){
         int k = Key::idxBlack[i];
-        for(auto&& noteBlock : recorder.track.lanes[k]){
-            double yon = y0 + (timePointer - noteBlock.on) * pixelsPerSecond;
-            double yoff = y0 + (timePointer - noteBlock.off) * pixelsPerSecond;
-            if(noteBlock.off > timePointer){
+        for(size_t n = recorderCursors[k], numNotes = recorder.notes.GetSize(k); n < numNotes; n++){
+            const NoteLog::Note& note = recorder.notes.Get(k, n);
+            double off = note.off.load(std::memory_order_acquire);
+            double yon = y0 + (timePointer - note.on) * pixelsPerSecond;
+            double yoff = y0 + (timePointer - off) * pixelsPerSecond;
+            if(off > timePointer){
                 yoff = -noteRadius - edgeSize;
             }
             double y = yoff;
@@ -213,12 +186,12 @@ void LaneManager::Draw(NVGcontext* vg, Recorder& recorder, MusicalKeyboard& keyb
             // Draw the note block
             nvgBeginPath(vg);
             nvgRoundedRect(vg, this->lanes[k].x, (float)y, this->lanes[k].w, (float)h, noteRadius);
-            nvgFillColor(vg, nvgRGBA(uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.track.colorBlackKey.r)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.track.colorBlackKey.g)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.track.colorBlackKey.b)), 255));
+            nvgFillColor(vg, nvgRGBA(uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.colorBlackKey.r)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.colorBlackKey.g)), uint8_t(NOTE_BLOCK_COLOR_SCALE_EDGE * double(recorder.colorBlackKey.b)), 255));
             nvgFill(vg);
             nvgBeginPath(vg);
             nvgRoundedRect(vg, this->lanes[k].x + edgeSize, (float)y + edgeSize, this->lanes[k].w - edgeSize2, (float)h - edgeSize2, noteRadius - edgeSize);
-            NVGcolor colorGradientBegin = nvgRGBA(uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.track.colorBlackKey.r), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.track.colorBlackKey.g), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.track.colorBlackKey.b),255.0)), 255);
-            NVGcolor colorGradientEnd = nvgRGBA(recorder.track.colorBlackKey.r, recorder.track.colorBlackKey.g, recorder.track.colorBlackKey.b, 255);
+            NVGcolor colorGradientBegin = nvgRGBA(uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.colorBlackKey.r), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.colorBlackKey.g), 255.0)), uint8_t(std::min(NOTE_BLOCK_COLOR_SCALE_GRADIENT * double(recorder.colorBlackKey.b),255.0)), 255);
+            NVGcolor colorGradientEnd = nvgRGBA(recorder.colorBlackKey.r, recorder.colorBlackKey.g, recorder.colorBlackKey.b, 255);
             NVGpaint gradient = nvgLinearGradient(vg, this->lanes[k].x + edgeSize, 0.0f, this->lanes[k].x + this->lanes[k].w - edgeSize2, 0.0f, colorGradientBegin, colorGradientEnd);
             nvgFillPaint(vg, gradient);
             nvgFill(vg);
@@ -227,11 +200,10 @@ void LaneManager::Draw(NVGcontext* vg, Recorder& recorder, MusicalKeyboard& keyb
             bool pressed = yoff < 0.0;
             keyboard.keys[k].pressed |= pressed;
             if(pressed){
-                keyboard.keys[k].color = recorder.track.colorBlackKey;
+                keyboard.keys[k].color = recorder.colorBlackKey;
             }
         }
     }
-    recorder.mtxTrack.unlock();
     nvgResetScissor(vg);
 }
 
@@ -261,6 +233,7 @@ void LaneManager::Resize(GLFWwindow* wnd, glm::ivec2 lowerBound, glm::ivec2 uppe
     }
     noteRadius = this->dimension.x * (float)NOTE_BLOCK_RADIUS;
     edgeSize = this->dimension.x * (float)NOTE_BLOCK_EDGE;
+    layerValid = false;
     (void)wnd;
     (void)upperBound;
 }
@@ -4,6 +4,7 @@
 #include <MusicalKeyboard.hpp>
 #include <Sequencer.hpp>
 #include <Recorder.hpp>
+#include <NoteBlockRenderer.hpp>
 #include <nanovg/nanovg_gl.h>
 
 
@@ -26,13 +27,33 @@ class LaneManager {
         LaneManager();
 
         /**
-         *  @brief Draw the lanes.
+         *  @brief Render the static background layer of the lanes if the layout has changed.
+         *  @param [in] vg Vector-graphic context. No frame must be in progress.
+         *  @param [in] pxRatio Ratio of framebuffer size to window size.
+         */
+        void UpdateLayer(NVGcontext* vg, float pxRatio);
+
+        /**
+         *  @brief Delete the static background layer.
+         */
+        void DeleteLayer(void);
+
+        /**
+         *  @brief Draw the background of the lanes by compositing the static background layer.
          *  @param [in] vg Vector-graphic context.
+         */
+        void DrawBackground(NVGcontext* vg);
+
+        /**
+         *  @brief Draw the note blocks of a sequencer and update the keyboard.
+         *  @param [in] noteBlockRenderer The note block renderer that contains the uploaded note blocks of the sequencer.
          *  @param [in] sequencer The sequencer that contains the data of the performance.
          *  @param [in] timePointer Current time point of the performance in seconds.
          *  @param [in] keyboard The keyboard that should be updated.
+         *  @param [in] windowSize Size of the window in pixels.
+         *  @details The note blocks are drawn with OpenGL, this function must not be called between nvgBeginFrame and nvgEndFrame.
          */
-        void Draw(NVGcontext* vg, Sequencer& sequencer, double timePointer, MusicalKeyboard& keyboard);
+        void Draw(NoteBlockRenderer& noteBlockRenderer, Sequencer& sequencer, double timePointer, MusicalKeyboard& keyboard, glm::vec2 windowSize);
 
         /**
          *  @brief Draw the lanes.
@@ -89,5 +110,13 @@ class LaneManager {
         glm::vec2 dimension;    ///< The dimension of the total lane field in pixels.
         float noteRadius;       ///< Radius for rounded rect of note block in pixels.
         float edgeSize;         ///< Edge size for rounded rect of note block in pixels.
+
+        /* Static background layer */
+        FrameBufferLayer layer; ///< Offscreen layer that contains the background of all lanes.
+        bool layerValid;        ///< True if the layer matches the current layout.
+
+        /* Recording view */
+        std::array<size_t, 88> recorderCursors;   ///< Index of the first recorded note of each lane that may still be visible.
+        double recorderCutoff;                    ///< Notes that are off before this time are behind the cursors.
 };
 
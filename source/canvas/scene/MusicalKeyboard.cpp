@@ -21,97 +21,174 @@ const int Key::idxBlack[] = {  1,    4,  6,    9,   11,   13,      16,   18,
 const int Key::idxWhite[] = {0,  2,3,  5,  7,8,  10,   12,   14,15,   17,   19,20,   22,   24,   26,27,   29,   31,32,   34,   36,   38,39,   41,   43,44,   46,   48,   50,51,   53,   55,56,   58,   60,   62,63,   65,   67,68,   70,   72,   74,75,   77,   79,80,   82,   84,   86,87};
 
 
-void MusicalKeyboard::Draw(NVGcontext* vg){
+MusicalKeyboard::MusicalKeyboard(){
+    layerValid = false;
+}
+
+void MusicalKeyboard::UpdateLayer(NVGcontext* vg, float pxRatio){
+    if(layerValid){
+        return;
+    }
+    if(!layer.Begin(vg, position, dimension, pxRatio)){
+        return;
+    }
+
     // Background
     nvgBeginPath(vg);
     nvgRect(vg, position.x, position.y, dimension.x, dimension.y);
     nvgFillColor(vg, nvgRGBA(10,10,10,255));
     nvgFill(vg);
 
-    // White keys
-    float sw = (whiteKeyDimension.x - keyEdge)*0.4f;
+    // All keys released
     for(int i = 0; i < 52; i++){
-        // Calculate final key color
-        NVGcolor clr1 = nvgRGBA(255,255,255,255);
-        NVGcolor clr2 = nvgRGBA(248,244,240,255);
-        if(keys[Key::idxWhite[i]].pressed){
-            clr1 = nvgRGBA(keys[Key::idxWhite[i]].color.r, keys[Key::idxWhite[i]].color.g, keys[Key::idxWhite[i]].color.b, 255);
-            clr2 = nvgRGBA((uint8_t)(double(keys[Key::idxWhite[i]].color.r) / 255.0 * 248.0), (uint8_t)(double(keys[Key::idxWhite[i]].color.g) / 255.0 * 244.0), (uint8_t)(double(keys[Key::idxWhite[i]].color.b) / 255.0 * 240), 255);
-        }
+        DrawWhiteKey(vg, i, false, false);
+    }
+    for(int i = 0; i < 36; i++){
+        DrawBlackKey(vg, i, false);
+    }
+    DrawTopEdge(vg);
+    layer.End(vg);
+    layerValid = true;
+}
 
-        // white border
-        nvgBeginPath(vg);
-        nvgRoundedRectVarying(vg, keys[Key::idxWhite[i]].x, keyPositionY, whiteKeyDimension.x, whiteKeyDimension.y, 0.0f, 0.0f, whiteKeyRadius, whiteKeyRadius);
-        nvgFillColor(vg, clr1);
-        nvgFill(vg);
+void MusicalKeyboard::DeleteLayer(void){
+    layer.Delete();
+    layerValid = false;
+}
 
-        // nearly white main color
-        nvgBeginPath(vg);
-        nvgRoundedRectVarying(vg, keys[Key::idxWhite[i]].x, keyPositionY, whiteKeyDimension.x - keyEdge, whiteKeyDimension.y - keyEdge, 0.0f, 0.0f, whiteKeyRadius, whiteKeyRadius - keyEdge);
-        nvgFillColor(vg, clr2);
-        nvgFill(vg);
+void MusicalKeyboard::Draw(NVGcontext* vg){
+    layer.Draw(vg);
 
-        // Shadow of neighbor white key
-        int n = i - 1;
-        if(keys[Key::idxWhite[i]].pressed && !((n >= 0) && keys[Key::idxWhite[n]].pressed)){
+    // Keys to be redrawn: pressed keys and all keys they overlap (a black key and its shadow overlap both white neighbors)
+    std::array<bool, 88> redraw;
+    bool anyRedraw = false;
+    for(int k = 0; k < 88; k++){
+        redraw[k] = keys[k].pressed;
+        anyRedraw |= redraw[k];
+    }
+    if(!anyRedraw){
+        return;
+    }
+    bool changed = true;
+    while(changed){
+        changed = false;
+        for(int i = 0; i < 36; i++){
+            int k = Key::idxBlack[i];
+            if((redraw[k-1] || redraw[k] || redraw[k+1]) && !(redraw[k-1] && redraw[k] && redraw[k+1])){
+                redraw[k-1] = redraw[k] = redraw[k+1] = true;
+                changed = true;
+            }
+        }
+    }
+
+    // Draw the keys on top of the layer, the top edge is restored for the affected range only
+    float xMin = position.x + dimension.x;
+    float xMax = position.x;
+    for(int i = 0; i < 52; i++){
+        int k = Key::idxWhite[i];
+        if(redraw[k]){
             nvgBeginPath(vg);
-            nvgRoundedRectVarying(vg, keys[Key::idxWhite[i]].x, keyPositionY, sw, whiteKeyDimension.y, 0.0f, 0.0f, whiteKeyRadius, whiteKeyRadius);
-            NVGpaint gradient = nvgLinearGradient(vg, keys[Key::idxWhite[i]].x, keyPositionY, keys[Key::idxWhite[i]].x + sw, keyPositionY, nvgRGBA(0,0,0,80), nvgRGBA(0,0,0,0));
-            nvgFillPaint(vg, gradient);
+            nvgRect(vg, keys[k].x, keyPositionY, whiteKeyDimension.x, whiteKeyDimension.y);
+            nvgFillColor(vg, nvgRGBA(10,10,10,255));
             nvgFill(vg);
+            DrawWhiteKey(vg, i, keys[k].pressed, (i > 0) && keys[Key::idxWhite[i - 1]].pressed);
+            xMin = std::min(xMin, (float)keys[k].x);
+            xMax = std::max(xMax, (float)keys[k].x + whiteKeyDimension.x);
         }
     }
-
-    // Black keys
-    float ks2 = keySpacing + keySpacing;
-    float ke2 = keyEdge + keyEdge;
-    float r = 0.25f * blackKeyDimension.x;
-    sw = (float)BLACK_KEY_SHADOW_WIDTH * blackKeyDimension.x;
     for(int i = 0; i < 36; i++){
-        // Calculate final key color
-        NVGcolor clr1 = nvgRGBA(45,45,45,255);
-        NVGcolor clr2 = nvgRGBA(15,15,15,255);
-        float f = blackKeyDimension.x;
-        if(keys[Key::idxBlack[i]].pressed){
-            f *= 0.7f;
-            clr1 = nvgRGBA((uint8_t)(double(keys[Key::idxBlack[i]].color.r)), (uint8_t)(double(keys[Key::idxBlack[i]].color.g)), (uint8_t)(double(keys[Key::idxBlack[i]].color.b)), 255);
-            clr2 = nvgRGBA((uint8_t)(0.9 * double(keys[Key::idxBlack[i]].color.r)), (uint8_t)(0.9 * double(keys[Key::idxBlack[i]].color.g)), (uint8_t)(0.9 * double(keys[Key::idxBlack[i]].color.b)), 255);
+        if(redraw[Key::idxBlack[i]]){
+            DrawBlackKey(vg, i, keys[Key::idxBlack[i]].pressed);
         }
+    }
+    nvgScissor(vg, xMin, position.y, xMax - xMin, dimension.y);
+    DrawTopEdge(vg);
+    nvgResetScissor(vg);
+}
 
-        // Background for black keys
-        nvgBeginPath(vg);
-        nvgRect(vg, keys[Key::idxBlack[i]].x, keyPositionY, blackKeyDimension.x, blackKeyDimension.y);
-        nvgFillColor(vg, nvgRGBA(10,10,10,255));
-        nvgFill(vg);
-
-        // grey border
-        nvgBeginPath(vg);
-        nvgRect(vg, keys[Key::idxBlack[i]].x + keySpacing, keyPositionY, blackKeyDimension.x - ks2, blackKeyDimension.y - keySpacing);
-        nvgFillColor(vg, clr1);
-        nvgFill(vg);
+void MusicalKeyboard::DrawWhiteKey(NVGcontext* vg, int i, bool pressed, bool pressedLeft){
+    // Calculate final key color
+    const Key& key = keys[Key::idxWhite[i]];
+    NVGcolor clr1 = nvgRGBA(255,255,255,255);
+    NVGcolor clr2 = nvgRGBA(248,244,240,255);
+    if(pressed){
+        clr1 = nvgRGBA(key.color.r, key.color.g, key.color.b, 255);
+        clr2 = nvgRGBA((uint8_t)(double(key.color.r) / 255.0 * 248.0), (uint8_t)(double(key.color.g) / 255.0 * 244.0), (uint8_t)(double(key.color.b) / 255.0 * 240), 255);
+    }
 
-        // nearly black main color
-        nvgBeginPath(vg);
-        nvgRect(vg, keys[Key::idxBlack[i]].x + keySpacing + keyEdge, keyPositionY, blackKeyDimension.x - ks2 - ke2, blackKeyDimension.y - keySpacing - keyEdge);
-        nvgFillColor(vg, clr2);
-        nvgFill(vg);
+    // white border
+    nvgBeginPath(vg);
+    nvgRoundedRectVarying(vg, key.x, keyPositionY, whiteKeyDimension.x, whiteKeyDimension.y, 0.0f, 0.0f, whiteKeyRadius, whiteKeyRadius);
+    nvgFillColor(vg, clr1);
+    nvgFill(vg);
 
-        // highlight for bottom of key
-        nvgBeginPath(vg);
-        nvgRoundedRectVarying(vg, keys[Key::idxBlack[i]].x + keySpacing + keyEdge - 0.6f, keyPositionY + blackKeyDimension.y - keySpacing - f, blackKeyDimension.x - ks2 - ke2 + 1.2f, f, r, r, 0.0f, 0.0f);
-        nvgFillColor(vg, clr1);
-        nvgFill(vg);
+    // nearly white main color
+    nvgBeginPath(vg);
+    nvgRoundedRectVarying(vg, key.x, keyPositionY, whiteKeyDimension.x - keyEdge, whiteKeyDimension.y - keyEdge, 0.0f, 0.0f, whiteKeyRadius, whiteKeyRadius - keyEdge);
+    nvgFillColor(vg, clr2);
+    nvgFill(vg);
 
-        // Shadow
-        uint8_t shadowAlpha = keys[Key::idxBlack[i]].pressed ? 60 : 120;
+    // Shadow of neighbor white key
+    if(pressed && !pressedLeft){
+        float sw = (whiteKeyDimension.x - keyEdge)*0.4f;
         nvgBeginPath(vg);
-        nvgRect(vg, keys[Key::idxBlack[i]].x + blackKeyDimension.x, keyPositionY, sw, blackKeyDimension.y);
-        NVGpaint gradient = nvgLinearGradient(vg, keys[Key::idxBlack[i]].x + blackKeyDimension.x, keyPositionY, keys[Key::idxBlack[i]].x + blackKeyDimension.x + blackKeyShadowGradient.x, keyPositionY + blackKeyShadowGradient.y, nvgRGBA(0,0,0,shadowAlpha), nvgRGBA(0,0,0,0));
+        nvgRoundedRectVarying(vg, key.x, keyPositionY, sw, whiteKeyDimension.y, 0.0f, 0.0f, whiteKeyRadius, whiteKeyRadius);
+        NVGpaint gradient = nvgLinearGradient(vg, key.x, keyPositionY, key.x + sw, keyPositionY, nvgRGBA(0,0,0,80), nvgRGBA(0,0,0,0));
         nvgFillPaint(vg, gradient);
         nvgFill(vg);
     }
+}
+
+void MusicalKeyboard::DrawBlackKey(NVGcontext* vg, int i, bool pressed){
+    // Calculate final key color
+    const Key& key = keys[Key::idxBlack[i]];
+    float ks2 = keySpacing + keySpacing;
+    float ke2 = keyEdge + keyEdge;
+    float r = 0.25f * blackKeyDimension.x;
+    float sw = (float)BLACK_KEY_SHADOW_WIDTH * blackKeyDimension.x;
+    NVGcolor clr1 = nvgRGBA(45,45,45,255);
+    NVGcolor clr2 = nvgRGBA(15,15,15,255);
+    float f = blackKeyDimension.x;
+    if(pressed){
+        f *= 0.7f;
+        clr1 = nvgRGBA((uint8_t)(double(key.color.r)), (uint8_t)(double(key.color.g)), (uint8_t)(double(key.color.b)), 255);
+        clr2 = nvgRGBA((uint8_t)(0.9 * double(key.color.r)), (uint8_t)(0.9 * double(key.color.g)), (uint8_t)(0.9 * double(key.color.b)), 255);
+    }
+
+    // Background for black keys
+    nvgBeginPath(vg);
+    nvgRect(vg, key.x, keyPositionY, blackKeyDimension.x, blackKeyDimension.y);
+    nvgFillColor(vg, nvgRGBA(10,10,10,255));
+    nvgFill(vg);
+
+    // grey border
+    nvgBeginPath(vg);
+    nvgRect(vg, key.x + keySpacing, keyPositionY, blackKeyDimension.x - ks2, blackKeyDimension.y - keySpacing);
+    nvgFillColor(vg, clr1);
+    nvgFill(vg);
+
+    // nearly black main color
+    nvgBeginPath(vg);
+    nvgRect(vg, key.x + keySpacing + keyEdge, keyPositionY, blackKeyDimension.x - ks2 - ke2, blackKeyDimension.y - keySpacing - keyEdge);
+    nvgFillColor(vg, clr2);
+    nvgFill(vg);
+
+    // highlight for bottom of key
+    nvgBeginPath(vg);
+    nvgRoundedRectVarying(vg, key.x + keySpacing + keyEdge - 0.6f, keyPositionY + blackKeyDimension.y - keySpacing - f, blackKeyDimension.x - ks2 - ke2 + 1.2f, f, r, r, 0.0f, 0.0f);
+    nvgFillColor(vg, clr1);
+    nvgFill(vg);
+
+    // Shadow
+    uint8_t shadowAlpha = pressed ? 60 : 120;
+    nvgBeginPath(vg);
+    nvgRect(vg, key.x + blackKeyDimension.x, keyPositionY, sw, blackKeyDimension.y);
+    NVGpaint gradient = nvgLinearGradient(vg, key.x + blackKeyDimension.x, keyPositionY, key.x + blackKeyDimension.x + blackKeyShadowGradient.x, keyPositionY + blackKeyShadowGradient.y, nvgRGBA(0,0,0,shadowAlpha), nvgRGBA(0,0,0,0));
+    nvgFillPaint(vg, gradient);
+    nvgFill(vg);
+}
 
-    // Top edge
+void MusicalKeyboard::DrawTopEdge(NVGcontext* vg){
     nvgBeginPath(vg);
     nvgRect(vg, position.x, position.y, dimension.x, topEdgeHeight);
     NVGpaint gradient = nvgLinearGradient(vg, position.x, position.y, position.x, position.y + topEdgeHeight, nvgRGBA(90,90,90,255), nvgRGBA(40,40,40,255));
@@ -177,6 +254,7 @@ void MusicalKeyboard::Resize(GLFWwindow* wnd, glm::ivec2 lowerBound, glm::ivec2
     position.y = keyPositionY - topEdgeHeight;
     dimension.x = (GLfloat)width;
     dimension.y = !align ? (GLfloat)(topEdgeHeight + whiteKeyHeight + KEY_MARGIN_BOTTOM_PX) : (GLfloat)(topEdgeHeight + whiteKeyHeight + keyEdge);
+    layerValid = false;
     (void)wnd;
 }
 
@@ -2,6 +2,7 @@
 
 
 #include <Sequencer.hpp>
+#include <FrameBufferLayer.hpp>
 #include <nanovg/nanovg_gl.h>
 
 
@@ -20,9 +21,27 @@ class MusicalKeyboard {
     public:
         std::array<Key, 88> keys;      ///< Array of keys starting with A0.
 
+        /**
+         *  @brief Create a musical keyboard.
+         */
+        MusicalKeyboard();
+
+        /**
+         *  @brief Render the static layer of the keyboard (all keys released) if the layout has changed.
+         *  @param [in] vg Vector-graphic context. No frame must be in progress.
+         *  @param [in] pxRatio Ratio of framebuffer size to window size.
+         */
+        void UpdateLayer(NVGcontext* vg, float pxRatio);
+
+        /**
+         *  @brief Delete the static layer.
+         */
+        void DeleteLayer(void);
+
         /**
          *  @brief Draw the musical keyboard.
          *  @param [in] vg Vector-graphic context.
+         *  @details The static layer is composited and only pressed keys and the keys they overlap are drawn on top of it.
          */
         void Draw(NVGcontext* vg);
 
@@ -63,5 +82,32 @@ class MusicalKeyboard {
         glm::vec2 whiteKeyDimension;        ///< Dimension of a white key in pixels.
         glm::vec2 blackKeyDimension;        ///< Dimension of a black key in pixels.
         glm::vec2 blackKeyShadowGradient;   ///< Shadow gradient vector in pixels for black keys.
+
+        /* Static layer */
+        FrameBufferLayer layer;             ///< Offscreen layer that contains the keyboard with all keys released.
+        bool layerValid;                    ///< True if the layer matches the current layout.
+
+        /**
+         *  @brief Draw a white key.
+         *  @param [in] vg Vector-graphic context.
+         *  @param [in] i Index to @ref Key::idxWhite.
+         *  @param [in] pressed True if the key should be drawn in pressed state.
+         *  @param [in] pressedLeft True if the left neighboring white key is drawn in pressed state.
+         */
+        void DrawWhiteKey(NVGcontext* vg, int i, bool pressed, bool pressedLeft);
+
+        /**
+         *  @brief Draw a black key including its shadow.
+         *  @param [in] vg Vector-graphic context.
+         *  @param [in] i Index to @ref Key::idxBlack.
+         *  @param [in] pressed True if the key should be drawn in pressed state.
+         */
+        void DrawBlackKey(NVGcontext* vg, int i, bool pressed);
+
+        /**
+         *  @brief Draw the top edge of the keyboard.
+         *  @param [in] vg Vector-graphic context.
+         */
+        void DrawTopEdge(NVGcontext* vg);
 };
 
@@ -0,0 +1,134 @@
+#include <NoteBlockRenderer.hpp>
+#include <MusicalKeyboard.hpp>
+#include <FrameProfiler.hpp>
+
+
+NoteBlockRenderer::NoteBlockRenderer(){
+    vao = 0;
+    vbo = 0;
+}
+
+bool NoteBlockRenderer::Generate(void){
+    Delete();
+    if(!shader.Generate((float)NOTE_BLOCK_COLOR_SCALE_EDGE, (float)NOTE_BLOCK_COLOR_SCALE_GRADIENT)){
+        LogError("Could not create note block shader!\n");
+        return false;
+    }
+
+    // Attributes are advanced once per instance, the quad corners are generated from gl_VertexID
+    DEBUG_GLCHECK( glGenVertexArrays(1, &vao); );
+    DEBUG_GLCHECK( glGenBuffers(1, &vbo); );
+    DEBUG_GLCHECK( glBindVertexArray(vao); );
+        DEBUG_GLCHECK( glBindBuffer(GL_ARRAY_BUFFER, vbo); );
+        DEBUG_GLCHECK( glEnableVertexAttribArray(0); );
+        DEBUG_GLCHECK( glEnableVertexAttribArray(1); );
+        DEBUG_GLCHECK( glEnableVertexAttribArray(2); );
+        DEBUG_GLCHECK( glVertexAttribDivisor(0, 1); );
+        DEBUG_GLCHECK( glVertexAttribDivisor(1, 1); );
+        DEBUG_GLCHECK( glVertexAttribDivisor(2, 1); );
+    DEBUG_GLCHECK( glBindVertexArray(0); );
+    return true;
+}
+
+void NoteBlockRenderer::Delete(void){
+    shader.Delete();
+    if(vbo){
+        glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+    if(vao){
+        glDeleteVertexArrays(1, &vao);
+        vao = 0;
+    }
+    groups.clear();
+}
+
+void NoteBlockRenderer::Upload(const Sequencer& sequencer){
+    // Collect all note blocks, white keys and black keys of each track are kept in separate groups (white keys first).
+    // Note blocks of one group never overlap each other, only the order of the groups matters.
+    std::vector<std::vector<NoteBlockInstance>> instances(2 * sequencer.tracks.size());
+    std::array<bool, 88> isBlack;
+    isBlack.fill(false);
+    for(int i = 0; i < 36; i++){
+        isBlack[Key::idxBlack[i]] = true;
+    }
+    for(size_t t = 0; t < sequencer.tracks.size(); t++){
+        const SequenceTrack& track = sequencer.tracks[t];
+        for(int k = 0; k < 88; k++){
+            glm::u8vec3 color = isBlack[k] ? track.colorBlackKey : track.colorWhiteKey;
+            for(auto&& noteBlock : track.lanes[k]){
+                instances[2 * t + (isBlack[k] ? 1 : 0)].push_back({(GLfloat)noteBlock.on, (GLfloat)noteBlock.off, (GLfloat)k, {color.r, color.g, color.b, 255}});
+            }
+        }
+    }
+
+    // Sort each group by note on time and build the prefix maximum of note off times
+    std::vector<NoteBlockInstance> buffer;
+    groups.resize(instances.size());
+    for(size_t g = 0; g < groups.size(); g++){
+        std::stable_sort(instances[g].begin(), instances[g].end(), [](const NoteBlockInstance& a, const NoteBlockInstance& b){ return a.on < b.on; });
+        groups[g].offset = buffer.size();
+        groups[g].on.resize(instances[g].size());
+        groups[g].maxOff.resize(instances[g].size());
+        double maxOff = -std::numeric_limits<double>::infinity();
+        for(size_t n = 0; n < instances[g].size(); n++){
+            maxOff = std::max(maxOff, (double)instances[g][n].off);
+            groups[g].on[n] = (double)instances[g][n].on;
+            groups[g].maxOff[n] = maxOff;
+        }
+        buffer.insert(buffer.end(), instances[g].begin(), instances[g].end());
+    }
+
+    // Upload the instance buffer
+    if(vbo){
+        DEBUG_GLCHECK( glBindBuffer(GL_ARRAY_BUFFER, vbo); );
+        DEBUG_GLCHECK( glBufferData(GL_ARRAY_BUFFER, buffer.size() * sizeof(NoteBlockInstance), buffer.empty() ? nullptr : &buffer[0], GL_STATIC_DRAW); );
+        DEBUG_GLCHECK( glBindBuffer(GL_ARRAY_BUFFER, 0); );
+    }
+}
+
+void NoteBlockRenderer::Draw(double timePointer, double timeHorizon, const std::array<glm::vec2, 88>& lanes, glm::vec4 laneArea, glm::vec2 windowSize, float noteRadius, float edgeSize){
+    if(!vao){
+        return;
+    }
+    FrameProfiler::BeginStage(FRAME_STAGE_NOTE_BLOCKS);
+    shader.Use();
+    shader.SetLayout(lanes, laneArea, windowSize, noteRadius, edgeSize);
+    shader.SetTime((float)timePointer, (float)((double)laneArea.w / timeHorizon));
+    DEBUG_GLCHECK( glEnable(GL_BLEND); );
+    DEBUG_GLCHECK( glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA); );
+    DEBUG_GLCHECK( glDisable(GL_CULL_FACE); );
+    DEBUG_GLCHECK( glDisable(GL_DEPTH_TEST); );
+    DEBUG_GLCHECK( glDisable(GL_STENCIL_TEST); );
+    DEBUG_GLCHECK( glDisable(GL_SCISSOR_TEST); );
+    DEBUG_GLCHECK( glBindVertexArray(vao); );
+    DEBUG_GLCHECK( glBindBuffer(GL_ARRAY_BUFFER, vbo); );
+    uint32_t numVisible = 0, numTotal = 0;
+    for(auto&& group : groups){
+        numVisible += DrawGroup(group, timePointer, timePointer + timeHorizon);
+        numTotal += (uint32_t)group.on.size();
+    }
+    DEBUG_GLCHECK( glBindBuffer(GL_ARRAY_BUFFER, 0); );
+    DEBUG_GLCHECK( glBindVertexArray(0); );
+    FrameProfiler::EndStage(FRAME_STAGE_NOTE_BLOCKS);
+    FrameProfiler::SetNoteBlockCount(numVisible, numTotal - numVisible);
+}
+
+uint32_t NoteBlockRenderer::DrawGroup(const InstanceGroup& group, double tBegin, double tEnd){
+    // Visible instances: note on before the end of the time window and note off after its beginning
+    size_t last = std::upper_bound(group.on.begin(), group.on.end(), tEnd) - group.on.begin();
+    size_t first = std::lower_bound(group.maxOff.begin(), group.maxOff.begin() + last, tBegin) - group.maxOff.begin();
+    if(first >= last){
+        return 0;
+    }
+
+    // Point the instanced attributes to the first visible instance
+    const GLsizei stride = (GLsizei)sizeof(NoteBlockInstance);
+    const size_t base = (group.offset + first) * sizeof(NoteBlockInstance);
+    DEBUG_GLCHECK( glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(base + offsetof(NoteBlockInstance, on))); );
+    DEBUG_GLCHECK( glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(base + offsetof(NoteBlockInstance, key))); );
+    DEBUG_GLCHECK( glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)(base + offsetof(NoteBlockInstance, color))); );
+    DEBUG_GLCHECK( glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)(last - first)); );
+    return (uint32_t)(last - first);
+}
+
@@ -0,0 +1,85 @@
+#pragma once
+
+
+#define NOTE_BLOCK_COLOR_SCALE_EDGE       (0.25)   ///< Color scale for edge of note block.
+#define NOTE_BLOCK_COLOR_SCALE_GRADIENT   (1.4)    ///< Color scale for upper gradient color of note block color.
+
+
+#include <Sequencer.hpp>
+#include <ShaderNoteBlock.hpp>
+
+
+/**
+ *  @brief Class: NoteBlockRenderer
+ *  @details Keeps all note blocks of a sequencer in a GPU buffer and draws them with one instanced draw call per track and key color.
+ *  Tracks are drawn in order, white keys before black keys of each track, so note blocks overlap like in the nanovg implementation.
+ *  The note blocks are uploaded once by @ref Upload, shape, edge and gradient are computed by the shader.
+ */
+class NoteBlockRenderer {
+    public:
+        /**
+         *  @brief Create a note block renderer.
+         */
+        NoteBlockRenderer();
+
+        /**
+         *  @brief Generate the shader and the GPU buffers.
+         *  @return True if success, false otherwise.
+         */
+        bool Generate(void);
+
+        /**
+         *  @brief Delete the shader and the GPU buffers.
+         */
+        void Delete(void);
+
+        /**
+         *  @brief Upload all note blocks of a sequencer to the GPU.
+         *  @param [in] sequencer The sequencer whose tracks have already been generated.
+         */
+        void Upload(const Sequencer& sequencer);
+
+        /**
+         *  @brief Draw all note blocks that are inside the visible time window.
+         *  @param [in] timePointer Current time point of the performance in seconds.
+         *  @param [in] timeHorizon Time horizon of the lane field in seconds.
+         *  @param [in] lanes Horizontal position and width of all 88 lanes in pixels.
+         *  @param [in] laneArea Position (x,y) and dimension (z,w) of the total lane field in pixels (y from top to bottom).
+         *  @param [in] windowSize Size of the window in pixels.
+         *  @param [in] noteRadius Radius for rounded rect of note block in pixels.
+         *  @param [in] edgeSize Edge size for rounded rect of note block in pixels.
+         *  @details Must not be called between nvgBeginFrame and nvgEndFrame.
+         */
+        void Draw(double timePointer, double timeHorizon, const std::array<glm::vec2, 88>& lanes, glm::vec4 laneArea, glm::vec2 windowSize, float noteRadius, float edgeSize);
+
+    private:
+        class NoteBlockInstance {
+            public:
+                GLfloat on;         ///< Note on time in seconds.
+                GLfloat off;        ///< Note off time in seconds.
+                GLfloat key;        ///< Key index starting with A0.
+                GLubyte color[4];   ///< Color of the note block (RGBA).
+        };
+
+        class InstanceGroup {
+            public:
+                size_t offset;                ///< Index of the first instance of this group inside the instance buffer.
+                std::vector<double> on;       ///< Note on times of all instances in ascending order.
+                std::vector<double> maxOff;   ///< Prefix maximum of the note off times, used for visibility culling.
+        };
+
+        ShaderNoteBlock shader;              ///< The note block shader.
+        GLuint vao;                          ///< Vertex array object.
+        GLuint vbo;                          ///< Instance buffer object.
+        std::vector<InstanceGroup> groups;   ///< Instance groups of white keys and black keys of all tracks in drawing order.
+
+        /**
+         *  @brief Draw the visible range of an instance group.
+         *  @param [in] group The instance group.
+         *  @param [in] tBegin Start of the visible time window.
+         *  @param [in] tEnd End of the visible time window.
+         *  @return Number of note blocks that have been drawn.
+         */
+        uint32_t DrawGroup(const InstanceGroup& group, double tBegin, double tEnd);
+};
+
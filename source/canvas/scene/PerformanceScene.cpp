@@ -3,6 +3,22 @@
 #include <MainWindow.hpp>
 
 
+bool PerformanceScene::Initialize(GLFWwindow* wnd){
+    if(!noteBlockRenderer.Generate()){
+        return false;
+    }
+    noteBlockRenderer.Upload(sequencer);
+    (void)wnd;
+    return true;
+}
+
+void PerformanceScene::Terminate(GLFWwindow* wnd){
+    noteBlockRenderer.Delete();
+    keyboard.DeleteLayer();
+    laneManager.DeleteLayer();
+    (void)wnd;
+}
+
 void PerformanceScene::Resize(GLFWwindow* wnd, int width, int height){
     int h = (int)(0.02 * (double)width);
     keyboard.Resize(wnd, glm::ivec2(0,0), glm::ivec2(width, height - h));
@@ -10,9 +26,23 @@ void PerformanceScene::Resize(GLFWwindow* wnd, int width, int height){
     progressBar.Resize(wnd, glm::ivec2(0, height - h), glm::ivec2(width, height));
 }
 
-void PerformanceScene::Draw(NVGcontext* vg){
+bool PerformanceScene::IsAnimating(void){
+    return AudioEngine::StreamIsPlaying() || progressBar.GetTimeScrollMode() || laneManager.GetTimeScrollMode();
+}
+
+void PerformanceScene::UpdateLayers(NVGcontext* vg, float pxRatio){
+    keyboard.UpdateLayer(vg, pxRatio);
+    laneManager.UpdateLayer(vg, pxRatio);
+}
+
+void PerformanceScene::Draw(NVGcontext* vg, glm::vec2 windowSize, float pxRatio){
     double timePointer = AudioEngine::GetTimePointer();
-    laneManager.Draw(vg, sequencer, timePointer, keyboard);
+    laneManager.DrawBackground(vg);
+
+    // Note blocks are drawn by the GPU on top of the background, the keyboard is drawn on top of the note blocks
+    nvgEndFrame(vg);
+    laneManager.Draw(noteBlockRenderer, sequencer, timePointer, keyboard, windowSize);
+    nvgBeginFrame(vg, windowSize.x, windowSize.y, pxRatio);
     keyboard.Draw(vg);
     progressBar.Draw(vg);
 }
@@ -26,6 +56,7 @@ void PerformanceScene::Load(GLFWwindow* wnd, std::string filename){
         return;
     }
     sequencer.Generate();
+    noteBlockRenderer.Upload(sequencer);
 }
 
 void PerformanceScene::CallbackKey(GLFWwindow* wnd, int key, int scancode, int action, int mods){
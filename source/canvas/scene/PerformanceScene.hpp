@@ -5,15 +5,30 @@
 #include <LaneManager.hpp>
 #include <Sequencer.hpp>
 #include <ProgressBar.hpp>
+#include <NoteBlockRenderer.hpp>
 #include <nanovg/nanovg_gl.h>
 
 
 class PerformanceScene {
     public:
-        MusicalKeyboard keyboard;      ///< Musical keyboard visualization.
-        LaneManager laneManager;       ///< Lane visualization.
-        Sequencer sequencer;           ///< The sequencer which contains the data of the whole performance.
-        ProgressBar progressBar;       ///< The progress bar.
+        MusicalKeyboard keyboard;               ///< Musical keyboard visualization.
+        LaneManager laneManager;                ///< Lane visualization.
+        Sequencer sequencer;                    ///< The sequencer which contains the data of the whole performance.
+        ProgressBar progressBar;                ///< The progress bar.
+        NoteBlockRenderer noteBlockRenderer;    ///< GPU renderer for the note blocks of the sequencer.
+
+        /**
+         *  @brief Initialize the performance scene.
+         *  @param [in] wnd GLFW window.
+         *  @return True if success, false otherwise.
+         */
+        bool Initialize(GLFWwindow* wnd);
+
+        /**
+         *  @brief Terminate the performance scene.
+         *  @param [in] wnd GLFW window.
+         */
+        void Terminate(GLFWwindow* wnd);
 
         /**
          *  @brief Resize the performance scene.
@@ -23,11 +38,27 @@ class PerformanceScene {
          */
         void Resize(GLFWwindow* wnd, int width, int height);
 
+        /**
+         *  @brief Check whether the performance scene has to be rendered continuously.
+         *  @return True if the content changes without user input, false otherwise.
+         */
+        bool IsAnimating(void);
+
+        /**
+         *  @brief Render the static layers of the scene if the layout has changed.
+         *  @param [in] vg Vector-graphic context. No frame must be in progress.
+         *  @param [in] pxRatio Ratio of framebuffer size to window size.
+         */
+        void UpdateLayers(NVGcontext* vg, float pxRatio);
+
         /**
          *  @brief Draw the performance scene.
          *  @param [in] vg Vector-graphic context.
+         *  @param [in] windowSize Size of the window in pixels.
+         *  @param [in] pxRatio Ratio of framebuffer size to window size.
+         *  @details The frame of the vector-graphic context must have been started. It is ended and restarted to draw the note blocks in between.
          */
-        void Draw(NVGcontext* vg);
+        void Draw(NVGcontext* vg, glm::vec2 windowSize, float pxRatio);
 
         /**
          *  @brief Load the performance from a MIDI file.
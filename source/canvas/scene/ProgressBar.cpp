@@ -36,7 +36,7 @@ void ProgressBar::Draw(NVGcontext* vg){
     nvgFill(vg);
 
     // Progress bar
-    float progress = (float)(!MainWindow::canvas.scene.performance.sequencer.maxNumSamples ? 0.0 : (AudioEngine::GetTimePointer() / ((double)MainWindow::canvas.scene.performance.sequencer.maxNumSamples / ((double)(AUDIO_ENGINE_SAMPLE_RATE + AUDIO_ENGINE_SAMPLE_RATE)))));
+    float progress = (float)(!MainWindow::canvas.scene.performance.sequencer.maxNumSamples ? 0.0 : (AudioEngine::GetTimePointer() / ((double)MainWindow::canvas.scene.performance.sequencer.maxNumSamples / ((double)(2 * AudioEngine::GetSampleRate())))));
     progress = std::clamp(progress, 0.0f, 1.0f);
     if(progress > 0.0){
         float x = position.x + padding + edge;
@@ -73,7 +73,7 @@ void ProgressBar::CallbackCursorPosition(GLFWwindow* wnd, double xpos, double yp
     // Change time pointer
     if(timeScrollMode){
         double scale = std::clamp((xpos - xs) / (xe - xs), 0.0, 1.0);
-        AudioEngine::SetTimePointer(scale * (double)(MainWindow::canvas.scene.performance.sequencer.maxNumSamples / 2) / (double)(AUDIO_ENGINE_SAMPLE_RATE));
+        AudioEngine::SetTimePointer(scale * (double)(MainWindow::canvas.scene.performance.sequencer.maxNumSamples / 2) / (double)(AudioEngine::GetSampleRate()));
     }
     (void)wnd;
 }
@@ -92,7 +92,7 @@ void ProgressBar::CallbackMouseButton(GLFWwindow* wnd, int button, int action, i
             double xs = (double)(position.x + padding + edge + radius);
             double xe = (double)(position.x + dimension.x - padding - edge);
             double scale = std::clamp((xpos - xs) / (xe - xs), 0.0, 1.0);
-            AudioEngine::SetTimePointer(scale * (double)(MainWindow::canvas.scene.performance.sequencer.maxNumSamples / 2) / (double)(AUDIO_ENGINE_SAMPLE_RATE));
+            AudioEngine::SetTimePointer(scale * (double)(MainWindow::canvas.scene.performance.sequencer.maxNumSamples / 2) / (double)(AudioEngine::GetSampleRate()));
         }
         else if((GLFW_RELEASE == action) && timeScrollMode){
             timeScrollMode = false;
@@ -2,12 +2,30 @@
 #include <MainWindow.hpp>
 
 
+void RecordingScene::Terminate(GLFWwindow* wnd){
+    keyboard.DeleteLayer();
+    laneManager.DeleteLayer();
+    (void)wnd;
+}
+
 void RecordingScene::Resize(GLFWwindow* wnd, int width, int height){
     keyboard.Resize(wnd, glm::ivec2(0,0), glm::ivec2(width, height), 1);
     laneManager.Resize(wnd, glm::ivec2(0,0), glm::ivec2(width, height), keyboard, 1);
 }
 
+bool RecordingScene::IsAnimating(void){
+    return recorder.IsRecording();
+}
+
+void RecordingScene::UpdateLayers(NVGcontext* vg, float pxRatio){
+    keyboard.UpdateLayer(vg, pxRatio);
+    laneManager.UpdateLayer(vg, pxRatio);
+}
+
 void RecordingScene::Draw(NVGcontext* vg){
+    if(recorder.IsRecording()){
+        recorder.Reserve();
+    }
     laneManager.Draw(vg, recorder, keyboard);
     keyboard.Draw(vg);
 }
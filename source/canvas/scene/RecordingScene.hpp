@@ -13,6 +13,12 @@ class RecordingScene {
         LaneManager laneManager;       ///< Lane visualization.
         Recorder recorder;             ///< The MIDI recorder.
 
+        /**
+         *  @brief Terminate the recording scene.
+         *  @param [in] wnd GLFW window.
+         */
+        void Terminate(GLFWwindow* wnd);
+
         /**
          *  @brief Resize the recording scene.
          *  @param [in] wnd GLFW window.
@@ -21,6 +27,19 @@ class RecordingScene {
          */
         void Resize(GLFWwindow* wnd, int width, int height);
 
+        /**
+         *  @brief Check whether the recording scene has to be rendered continuously.
+         *  @return True if the content changes without user input, false otherwise.
+         */
+        bool IsAnimating(void);
+
+        /**
+         *  @brief Render the static layers of the scene if the layout has changed.
+         *  @param [in] vg Vector-graphic context. No frame must be in progress.
+         *  @param [in] pxRatio Ratio of framebuffer size to window size.
+         */
+        void UpdateLayers(NVGcontext* vg, float pxRatio);
+
         /**
          *  @brief Draw the recording scene.
          *  @param [in] vg Vector-graphic context.
@@ -14,6 +14,11 @@ bool Scene::Initialize(GLFWwindow* wnd){
         Terminate(wnd);
         return false;
     }
+    if(!performance.Initialize(wnd)){
+        LogError("Could not initialize performance scene!\n");
+        Terminate(wnd);
+        return false;
+    }
     if(!menu.Initialize(wnd)){
         LogError("Could not initialize GUI!\n");
         Terminate(wnd);
@@ -26,6 +31,8 @@ bool Scene::Initialize(GLFWwindow* wnd){
 
 void Scene::Terminate(GLFWwindow* wnd){
     menu.Terminate();
+    performance.Terminate(wnd);
+    recording.Terminate(wnd);
     if(ctxVG){
         nvgDeleteGL3(ctxVG);
         ctxVG = nullptr;
@@ -38,18 +45,32 @@ void Scene::Update(GLFWwindow* wnd, double dt){
     (void)dt;
 }
 
+bool Scene::IsAnimating(void){
+    switch(sceneMode){
+        case SCENE_MODE_PERFORMANCE: return performance.IsAnimating();
+        case SCENE_MODE_RECORDING: return recording.IsAnimating();
+    }
+    return false;
+}
+
 void Scene::Draw(GLFWwindow* wnd){
     if(!ctxVG) return;
     int winWidth, winHeight, fbWidth, fbHeight;
     glfwGetWindowSize(wnd, &winWidth, &winHeight);
     glfwGetFramebufferSize(wnd, &fbWidth, &fbHeight);
     float pxRatio = (float)fbWidth / (float)winWidth;
+    switch(sceneMode){
+        case SCENE_MODE_PERFORMANCE: performance.UpdateLayers(ctxVG, pxRatio); break;
+        case SCENE_MODE_RECORDING: recording.UpdateLayers(ctxVG, pxRatio); break;
+    }
     nvgBeginFrame(ctxVG, winWidth, winHeight, pxRatio);
     switch(sceneMode){
-        case SCENE_MODE_PERFORMANCE: performance.Draw(ctxVG); break;
+        case SCENE_MODE_PERFORMANCE: performance.Draw(ctxVG, glm::vec2((float)winWidth, (float)winHeight), pxRatio); break;
         case SCENE_MODE_RECORDING: recording.Draw(ctxVG); break;
     }
+    FrameProfiler::BeginStage(FRAME_STAGE_NVG_END_FRAME);
     nvgEndFrame(ctxVG);
+    FrameProfiler::EndStage(FRAME_STAGE_NVG_END_FRAME);
     menu.Render();
 }
 
@@ -60,6 +81,10 @@ void Scene::Resize(GLFWwindow* wnd, int width, int height){
 }
 
 void Scene::CallbackKey(GLFWwindow* wnd, int key, int scancode, int action, int mods){
+    // F3: Show/hide performance info
+    if((GLFW_KEY_F3 == key) && (GLFW_PRESS == action)){
+        menu.TogglePerformanceInfo();
+    }
     switch(sceneMode){
         case SCENE_MODE_PERFORMANCE: performance.CallbackKey(wnd, key, scancode, action, mods); break;
         case SCENE_MODE_RECORDING: recording.CallbackKey(wnd, key, scancode, action, mods); break;
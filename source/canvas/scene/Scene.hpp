@@ -45,6 +45,12 @@ class Scene {
          */
         void Update(GLFWwindow* wnd, double dt);
 
+        /**
+         *  @brief Check whether the scene has to be rendered continuously.
+         *  @return True if the content changes without user input, false otherwise.
+         */
+        bool IsAnimating(void);
+
         /**
          *  @brief Draw the scene.
          *  @param [in] wnd GLFW window.
@@ -4,6 +4,7 @@
 GUIMenu::GUIMenu(){
     screen = nullptr;
     performanceInfo = nullptr;
+    FrameProfiler::SetEnabled(false);
 }
 
 bool GUIMenu::Initialize(GLFWwindow* wnd){
@@ -11,6 +12,7 @@ bool GUIMenu::Initialize(GLFWwindow* wnd){
     screen = new nanogui::Screen();
     screen->initialize(wnd, false);
     performanceInfo = new WidgetPerformanceInfo(screen);
+    performanceInfo->setVisible(false);
     screen->setVisible(true);
     screen->performLayout();
     return true;
@@ -25,13 +27,22 @@ void GUIMenu::Terminate(void){
 }
 
 void GUIMenu::Render(void){
-    //#TODO: Render GUI
-    // if(screen){
-        // screen->update();
-        // screen->performLayout();
-        // screen->drawContents();
-        // screen->drawWidgets();
-    // }
+    // Nothing to draw if no GUI element is visible
+    if(!screen || !performanceInfo || !performanceInfo->visible()){
+        return;
+    }
+    screen->update();
+    screen->drawWidgets();
+}
+
+void GUIMenu::TogglePerformanceInfo(void){
+    if(!screen || !performanceInfo){
+        return;
+    }
+    bool visible = !performanceInfo->visible();
+    performanceInfo->setVisible(visible);
+    FrameProfiler::SetEnabled(visible);
+    screen->performLayout();
 }
 
 bool GUIMenu::CursorOverGUI(glm::dvec2 cursor){
@@ -29,6 +29,11 @@ class GUIMenu {
          */
         void Render(void);
 
+        /**
+         *  @brief Show or hide the performance info and enable the frame profiler while it is shown.
+         */
+        void TogglePerformanceInfo(void);
+
         /**
          *  @brief Check if mouse cursor is over GUI menu.
          *  @param [in] cursor Mouse cursor position.
@@ -1,33 +1,107 @@
 #include <WidgetPerformanceInfo.hpp>
+#include <AudioEngine.hpp>
 
 
-WidgetPerformanceInfo::WidgetPerformanceInfo(nanogui::Widget *parent): NonmovableWindow(parent, ""){
+WidgetPerformanceInfo::WidgetPerformanceInfo(nanogui::Widget *parent): NonmovableWindow(parent, "Performance"){
     using namespace nanogui;
     this->setPosition(Vector2i(0, 0));
+    this->setLayout(new GroupLayout(10, 2, 10, 10));
 
-    this->button = new Button(this, "Test Button", ENTYPO_ICON_TV);
-    this->button->setFixedSize(Vector2i(0,0));
-    this->button->setFontSize(50);
-    this->button->setCallback([](){
-        printf("# BUTTON CALLBACK #\n");
-    });
-}
+    // Frame stages
+    new Label(this, "Frame stages (CPU / GPU)", "sans-bold");
+    for(int s = 0; s < FRAME_STAGE_COUNT; s++){
+        labelStages[s] = new Label(this, "");
+        labelStages[s]->setFixedWidth(PERFORMANCE_INFO_WIDTH);
+    }
+    graphCPU = new Graph(this, "CPU frame time");
+    graphCPU->setFixedSize(Vector2i(PERFORMANCE_INFO_WIDTH, 60));
+    graphGPU = new Graph(this, "GPU frame time");
+    graphGPU->setFixedSize(Vector2i(PERFORMANCE_INFO_WIDTH, 60));
+    graphGPU->setForegroundColor(Color(100, 200, 255, 255));
 
-nanogui::Vector2i WidgetPerformanceInfo::preferredSize(NVGcontext *ctx)const{
-    using namespace nanogui;
-    (void)ctx;
-    return Vector2i(500, 500);
+    // Scene
+    new Label(this, "Scene", "sans-bold");
+    labelNoteBlocks = new Label(this, "");
+    labelNoteBlocks->setFixedWidth(PERFORMANCE_INFO_WIDTH);
+
+    // Audio
+    new Label(this, "Audio", "sans-bold");
+    labelAudio = new Label(this, "");
+    labelAudio->setFixedWidth(PERFORMANCE_INFO_WIDTH);
+    labelNoteCache = new Label(this, "");
+    labelNoteCache->setFixedWidth(PERFORMANCE_INFO_WIDTH);
+    graphAudio = new Graph(this, "Callback load");
+    graphAudio->setFixedSize(Vector2i(PERFORMANCE_INFO_WIDTH, 60));
+    graphAudio->setForegroundColor(Color(120, 255, 120, 255));
+    audioHistory.resize(FRAME_PROFILER_HISTORY_SIZE, 0.0f);
+    audioHistoryIndex = 0;
 }
 
-void WidgetPerformanceInfo::performLayout(NVGcontext *ctx){
-    using namespace nanogui;
-    Widget::performLayout(ctx);
+void WidgetPerformanceInfo::update(NVGcontext *ctx){
+    char text[128];
 
-    this->button->setPosition(Vector2i(100,100));
+    // Frame stages
+    for(int s = 0; s < FRAME_STAGE_COUNT; s++){
+        FrameStage stage = (FrameStage)s;
+        if(FRAME_STAGE_SWAP == stage){
+            snprintf(text, sizeof(text), "%-16s %6.2f ms", FrameProfiler::GetStageName(stage), FrameProfiler::GetAverage(stage, false));
+        }
+        else{
+            snprintf(text, sizeof(text), "%-16s %6.2f ms / %6.2f ms", FrameProfiler::GetStageName(stage), FrameProfiler::GetAverage(stage, false), FrameProfiler::GetAverage(stage, true));
+        }
+        labelStages[s]->setCaption(text);
+    }
+
+    // The frame time is the sum of all top-level stages
+    const FrameStage topLevelStages[] = {FRAME_STAGE_SCENE_DRAW, FRAME_STAGE_POST_PROCESSING, FRAME_STAGE_SWAP};
+    for(int gpu = 0; gpu < 2; gpu++){
+        std::vector<float> frameTime(FRAME_PROFILER_HISTORY_SIZE, 0.0f);
+        for(auto&& stage : topLevelStages){
+            FrameProfiler::GetHistory(stage, (bool)gpu, history);
+            for(size_t k = 0; k < frameTime.size(); k++){
+                frameTime[k] += history[k];
+            }
+        }
+        SetGraphValues(gpu ? graphGPU : graphCPU, frameTime, PERFORMANCE_INFO_FRAME_SCALE_MS);
+    }
+
+    // Scene
+    uint32_t numVisible, numCulled;
+    FrameProfiler::GetNoteBlockCount(numVisible, numCulled);
+    snprintf(text, sizeof(text), "Note blocks: %u visible, %u culled", numVisible, numCulled);
+    labelNoteBlocks->setCaption(text);
+
+    // Audio callback, the load is the callback duration relative to the duration of one audio buffer
+    double duration;
+    uint32_t numXRuns;
+    AudioEngine::GetCallbackStatistics(duration, numXRuns);
+    const double bufferDuration = (double)AUDIO_ENGINE_SAMPLE_BUFFER_SIZE / (double)AudioEngine::GetSampleRate();
+    audioHistory[audioHistoryIndex] = (float)(duration / bufferDuration);
+    audioHistoryIndex = (audioHistoryIndex + 1) % audioHistory.size();
+    snprintf(text, sizeof(text), "Callback: %.3f ms (%.1f %%), xruns: %u", 1000.0 * duration, 100.0 * duration / bufferDuration, numXRuns);
+    labelAudio->setCaption(text);
+    std::rotate_copy(audioHistory.begin(), audioHistory.begin() + audioHistoryIndex, audioHistory.end(), history.begin());
+    SetGraphValues(graphAudio, history, 1.0f);
+
+    // Note render cache
+    double hitRate;
+    size_t numBytes;
+    AudioEngine::GetNoteCacheStatistics(hitRate, numBytes);
+    snprintf(text, sizeof(text), "Note cache: %.1f %% hits, %.1f MB", 100.0 * hitRate, (double)numBytes / (1024.0 * 1024.0));
+    labelNoteCache->setCaption(text);
     (void)ctx;
 }
 
-void WidgetPerformanceInfo::update(NVGcontext *ctx){
-    (void)ctx;
+void WidgetPerformanceInfo::SetGraphValues(nanogui::Graph* graph, const std::vector<float>& values, float scale){
+    nanogui::VectorXf& v = graph->values();
+    v.resize((Eigen::Index)values.size());
+    float maxValue = 0.0f;
+    for(size_t k = 0; k < values.size(); k++){
+        v[(Eigen::Index)k] = std::clamp(values[k] / scale, 0.0f, 1.0f);
+        maxValue = std::max(maxValue, values[k]);
+    }
+    char text[32];
+    snprintf(text, sizeof(text), "max %.2f", maxValue);
+    graph->setHeader(text);
 }
 
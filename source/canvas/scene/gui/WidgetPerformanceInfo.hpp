@@ -1,7 +1,12 @@
 #pragma once
 
 
+#define PERFORMANCE_INFO_WIDTH              (360)    ///< Width of the performance info widget in pixels.
+#define PERFORMANCE_INFO_FRAME_SCALE_MS     (33.3f)  ///< Frame time in milliseconds that corresponds to the full height of a frame time graph.
+
+
 #include <NonmovableWindow.hpp>
+#include <FrameProfiler.hpp>
 #include <nanogui.h>
 
 
@@ -14,25 +19,29 @@ class WidgetPerformanceInfo: public NonmovableWindow {
         explicit WidgetPerformanceInfo(nanogui::Widget *parent);
 
         /**
-         *  @brief The preferred size of this button.
+         *  @brief Update event, the displayed values are taken from the frame profiler and the audio engine.
          *  @param [in] ctx NanoVG context.
-         *  @return Preferred size in pixels.
          */
-        nanogui::Vector2i preferredSize(NVGcontext *ctx)const override;
+        void update(NVGcontext *ctx)override;
 
-        /**
-         *  @brief Perform layout.
-         *  @param [in] ctx NanoVG context.
-         */
-        void performLayout(NVGcontext *ctx)override;
+    private:
+        std::array<nanogui::Label*, FRAME_STAGE_COUNT> labelStages;  ///< Average CPU and GPU times of all frame stages.
+        nanogui::Label* labelNoteBlocks;                              ///< Number of visible and culled note blocks.
+        nanogui::Label* labelAudio;                                   ///< Audio callback duration and number of xruns.
+        nanogui::Label* labelNoteCache;                               ///< Hit rate and memory of the note render cache.
+        nanogui::Graph* graphCPU;                                     ///< Rolling history of the CPU frame time.
+        nanogui::Graph* graphGPU;                                     ///< Rolling history of the GPU frame time.
+        nanogui::Graph* graphAudio;                                   ///< Rolling history of the audio callback load.
+        std::vector<float> history;                                   ///< Temporary buffer for a history of the frame profiler.
+        std::vector<float> audioHistory;                              ///< Rolling history of the audio callback load.
+        size_t audioHistoryIndex;                                     ///< Index of the next entry of @ref audioHistory.
 
         /**
-         *  @brief Update event.
-         *  @param [in] ctx NanoVG context.
+         *  @brief Set the values of a graph.
+         *  @param [in] graph The graph to be updated.
+         *  @param [in] values Values to be shown, oldest first.
+         *  @param [in] scale Value that corresponds to the full height of the graph.
          */
-        void update(NVGcontext *ctx)override;
-
-    private:
-        nanogui::Button* button;
+        void SetGraphValues(nanogui::Graph* graph, const std::vector<float>& values, float scale);
 };
 
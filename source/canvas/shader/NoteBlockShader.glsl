@@ -0,0 +1,94 @@
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// VERTEX SHADER
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#ifdef VERTEX_SHADER
+
+// Vertex shader input (one instance per note block)
+layout (location = 0) in vec2 noteTime;
+layout (location = 1) in float noteKey;
+layout (location = 2) in vec4 noteColor;
+
+
+// Vertex shader output
+out vec2 PixelPosition;
+flat out vec4 NoteRect;
+flat out vec3 NoteColor;
+
+
+// Uniforms / Constants
+uniform vec2 lanes[88];
+uniform vec4 laneArea;
+uniform vec2 windowSize;
+uniform float timePointer;
+uniform float pixelsPerSecond;
+
+
+// Vertex shader main
+void main(void){
+    // Note block in window pixels (y from top to bottom)
+    vec2 lane = lanes[int(noteKey)];
+    float yBottom = laneArea.y + laneArea.w - (noteTime.x - timePointer) * pixelsPerSecond;
+    float yTop = laneArea.y + laneArea.w - (noteTime.y - timePointer) * pixelsPerSecond;
+    NoteRect = vec4(lane.x, yTop, lane.y, yBottom - yTop);
+    NoteColor = noteColor.rgb;
+
+    // Triangle strip corner, the quad is clipped to the lane area
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+    float y0 = clamp(yTop, laneArea.y, laneArea.y + laneArea.w);
+    float y1 = clamp(yBottom, laneArea.y, laneArea.y + laneArea.w);
+    PixelPosition = vec2(lane.x + corner.x * lane.y, mix(y0, y1, corner.y));
+    gl_Position = vec4(2.0f * PixelPosition.x / windowSize.x - 1.0f, 1.0f - 2.0f * PixelPosition.y / windowSize.y, 0.0f, 1.0f);
+}
+
+#endif /* VERTEX_SHADER */
+
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// FRAGMENT SHADER
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#ifdef FRAGMENT_SHADER
+
+// Fragment shader input
+in vec2 PixelPosition;
+flat in vec4 NoteRect;
+flat in vec3 NoteColor;
+
+
+// Fragment shader output
+layout (location = 0) out vec4 FragColor;
+
+
+// Uniforms / Constants
+uniform float noteRadius;
+uniform float edgeSize;
+uniform float colorScaleEdge;
+uniform float colorScaleGradient;
+
+
+// Signed distance to a rounded rectangle (x, y, w, h)
+float RoundedRectDistance(vec2 p, vec4 rect, float radius){
+    vec2 halfSize = 0.5f * rect.zw;
+    radius = min(radius, min(halfSize.x, halfSize.y));
+    vec2 q = abs(p - rect.xy - halfSize) - halfSize + vec2(radius);
+    return length(max(q, vec2(0.0f))) + min(max(q.x, q.y), 0.0f) - radius;
+}
+
+
+// Fragment shader main
+void main(void){
+    // Outer edge and inner body of the note block
+    float edgeSize2 = edgeSize + edgeSize;
+    vec4 innerRect = vec4(NoteRect.xy + vec2(edgeSize), NoteRect.zw - vec2(edgeSize2));
+    float alphaOuter = clamp(0.5f - RoundedRectDistance(PixelPosition, NoteRect, noteRadius), 0.0f, 1.0f);
+    float alphaInner = clamp(0.5f - RoundedRectDistance(PixelPosition, innerRect, max(noteRadius - edgeSize, 0.0f)), 0.0f, 1.0f);
+
+    // Horizontal gradient of the inner body
+    float t = clamp((PixelPosition.x - innerRect.x) / max(NoteRect.z - 3.0f * edgeSize, 1.0f), 0.0f, 1.0f);
+    vec3 colorInner = mix(min(colorScaleGradient * NoteColor, vec3(1.0f)), NoteColor, t);
+    vec3 colorEdge = colorScaleEdge * NoteColor;
+
+    // Final fragment color
+    FragColor = vec4(mix(colorEdge, colorInner, alphaInner), alphaOuter);
+}
+
+#endif /* FRAGMENT_SHADER */
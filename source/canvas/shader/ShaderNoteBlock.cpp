@@ -0,0 +1,51 @@
+#include <ShaderNoteBlock.hpp>
+
+
+RESOURCE_EXTLD(source_canvas_shader_NoteBlockShader_glsl);
+
+
+ShaderNoteBlock::ShaderNoteBlock(){
+    locationLanes = 0;
+    locationLaneArea = 0;
+    locationWindowSize = 0;
+    locationNoteRadius = 0;
+    locationEdgeSize = 0;
+    locationTimePointer = 0;
+    locationPixelsPerSecond = 0;
+}
+
+ShaderNoteBlock::~ShaderNoteBlock(){}
+
+bool ShaderNoteBlock::Generate(float colorScaleEdge, float colorScaleGradient){
+    size_t len = RESOURCE_LDLEN(source_canvas_shader_NoteBlockShader_glsl);
+    const unsigned char* data = RESOURCE_LDVAR(source_canvas_shader_NoteBlockShader_glsl);
+    std::vector<uint8_t> fileData(data, data + len);
+    if(!Shader::Generate(fileData, Shader::GetShadingLanguageVersion())){
+        return false;
+    }
+    Use();
+    Uniform1f("colorScaleEdge", colorScaleEdge);
+    Uniform1f("colorScaleGradient", colorScaleGradient);
+    locationLanes = GetUniformLocation("lanes");
+    locationLaneArea = GetUniformLocation("laneArea");
+    locationWindowSize = GetUniformLocation("windowSize");
+    locationNoteRadius = GetUniformLocation("noteRadius");
+    locationEdgeSize = GetUniformLocation("edgeSize");
+    locationTimePointer = GetUniformLocation("timePointer");
+    locationPixelsPerSecond = GetUniformLocation("pixelsPerSecond");
+    return true;
+}
+
+void ShaderNoteBlock::SetLayout(const std::array<glm::vec2, 88>& lanes, glm::vec4 laneArea, glm::vec2 windowSize, float noteRadius, float edgeSize){
+    Uniform2fv(locationLanes, 88, &lanes[0].x);
+    Uniform4f(locationLaneArea, laneArea);
+    Uniform2f(locationWindowSize, windowSize);
+    Uniform1f(locationNoteRadius, noteRadius);
+    Uniform1f(locationEdgeSize, edgeSize);
+}
+
+void ShaderNoteBlock::SetTime(float timePointer, float pixelsPerSecond){
+    Uniform1f(locationTimePointer, timePointer);
+    Uniform1f(locationPixelsPerSecond, pixelsPerSecond);
+}
+
@@ -0,0 +1,56 @@
+#pragma once
+
+
+#include <Shader.hpp>
+
+
+class ShaderNoteBlock: protected Shader {
+    public:
+        using Shader::Use;
+        using Shader::Delete;
+
+        /**
+         *  @brief Create note block shader.
+         */
+        ShaderNoteBlock();
+
+        /**
+         *  @brief Delete note block shader.
+         */
+        ~ShaderNoteBlock();
+
+        /**
+         *  @brief Generate the shader.
+         *  @param [in] colorScaleEdge Color scale for the edge of a note block.
+         *  @param [in] colorScaleGradient Color scale for the upper gradient color of a note block.
+         *  @return True if success, false otherwise.
+         */
+        bool Generate(float colorScaleEdge, float colorScaleGradient);
+
+        /**
+         *  @brief Set the layout of the lanes.
+         *  @param [in] lanes Horizontal position and width of all 88 lanes in pixels.
+         *  @param [in] laneArea Position (x,y) and dimension (z,w) of the total lane field in pixels (y from top to bottom).
+         *  @param [in] windowSize Size of the window in pixels.
+         *  @param [in] noteRadius Radius for rounded rect of note block in pixels.
+         *  @param [in] edgeSize Edge size for rounded rect of note block in pixels.
+         */
+        void SetLayout(const std::array<glm::vec2, 88>& lanes, glm::vec4 laneArea, glm::vec2 windowSize, float noteRadius, float edgeSize);
+
+        /**
+         *  @brief Set the scroll state.
+         *  @param [in] timePointer Time pointer in seconds.
+         *  @param [in] pixelsPerSecond Scroll speed in pixels per second.
+         */
+        void SetTime(float timePointer, float pixelsPerSecond);
+
+    private:
+        GLint locationLanes;
+        GLint locationLaneArea;
+        GLint locationWindowSize;
+        GLint locationNoteRadius;
+        GLint locationEdgeSize;
+        GLint locationTimePointer;
+        GLint locationPixelsPerSecond;
+};
+
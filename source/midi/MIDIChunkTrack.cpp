@@ -4,7 +4,8 @@
 
 bool MIDIChunkTrack::Decode(const uint8_t* chunkData, const uint32_t length){
     this->events.clear();
-    std::vector<MIDIEvent> events;
+    this->payload.clear();
+    MIDIChunkTrack track;
     uint32_t index = 0;
     uint8_t previousStatus = 0;
     while(index < length){
@@ -31,58 +32,57 @@ bool MIDIChunkTrack::Decode(const uint8_t* chunkData, const uint32_t length){
         // Channel Voice Messages
         if(0x80 == (status & 0xF0)){ // Note Off Event
             if((index + 2) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
+            track.events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
             index += 2;
         }
         else if(0x90 == (status & 0xF0)){ // Note On Event
             if((index + 2) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
+            track.events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
             index += 2;
         }
         else if(0xA0 == (status & 0xF0)){ // Polyphonic Key Pressure (Aftertouch)
             if((index + 2) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
+            track.events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
             index += 2;
         }
         else if(0xB0 == (status & 0xF0)){ // Control Change or Channel Mode Message
             if((index + 2) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
+            track.events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
             index += 2;
         }
         else if(0xC0 == (status & 0xF0)){ // Program Change
             if((index + 1) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 1));
+            track.events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 1));
             index += 1;
         }
         else if(0xD0 == (status & 0xF0)){ // Channel Pressure (After-touch)
             if((index + 1) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 1));
+            track.events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 1));
             index += 1;
         }
         else if(0xE0 == (status & 0xF0)){ // Pitch Wheel Change
             if((index + 2) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
+            track.events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
             index += 2;
         }
         // System Common Messages
         else if(0xF0 == status){ // System Exclusive, 0xF7 indicates end of exlusive
-            MIDIEvent evt(deltaTime, status);
+            uint32_t start = index;
             while(index < length){
-                evt.data.push_back(chunkData[index++]);
-                if(0xF7 == evt.data.back()) break;
+                if(0xF7 == chunkData[index++]) break;
             }
-            events.push_back(std::move(evt));
+            track.AddEvent(deltaTime, status, &chunkData[start], index - start);
         }
         else if(0xF1 == status){ // Undefined
         }
         else if(0xF2 == status){ // Song Position Pointer
             if((index + 2) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
+            track.events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 2));
             index += 2;
         }
         else if(0xF3 == status){ // Song Select
             if((index + 1) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 1));
+            track.events.push_back(MIDIEvent(deltaTime, status, &chunkData[index], 1));
             index += 1;
         }
         else if(0xF4 == status){ // Undefined
@@ -91,7 +91,7 @@ bool MIDIChunkTrack::Decode(const uint8_t* chunkData, const uint32_t length){
         }
         else if(0xF6 == status){ // Tune Request
             if((index + 1) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status));
+            track.events.push_back(MIDIEvent(deltaTime, status));
         }
         else if(0xF7 == status){ // End Of Exclusive
             // This is part of data in the 0xF0 event
@@ -99,53 +99,52 @@ bool MIDIChunkTrack::Decode(const uint8_t* chunkData, const uint32_t length){
         // System Real-Time Messages
         else if(0xF8 == status){ // Timing Clock
             if((index + 1) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status));
+            track.events.push_back(MIDIEvent(deltaTime, status));
         }
         else if(0xF9 == status){ // Undefined
         }
         else if(0xFA == status){ // Start
             if((index + 1) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status));
+            track.events.push_back(MIDIEvent(deltaTime, status));
         }
         else if(0xFB == status){ // Continue
             if((index + 1) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status));
+            track.events.push_back(MIDIEvent(deltaTime, status));
         }
         else if(0xFC == status){ // Stop
             if((index + 1) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status));
+            track.events.push_back(MIDIEvent(deltaTime, status));
         }
         else if(0xFD == status){ // Undefined
         }
         else if(0xFE == status){ // Active Sensing
             if((index + 1) > length) return false;
-            events.push_back(MIDIEvent(deltaTime, status));
+            track.events.push_back(MIDIEvent(deltaTime, status));
         }
         // Meta Events
         else if(0xFF == status){ // Meta events
-            MIDIEvent evt(deltaTime, status);
             if((index + 1) > length) return false;
-            evt.data.push_back(chunkData[index++]);
+            uint32_t start = index++;
             uint32_t metaEventLength = 0;
             for(int i = 0; (i < 4) && (index < length); i++){
-                evt.data.push_back(chunkData[index++]);
                 metaEventLength <<= 7;
-                metaEventLength |= (evt.data.back() & 0x7F);
-                if(!(0x80 & evt.data.back())){
+                metaEventLength |= (chunkData[index] & 0x7F);
+                if(!(0x80 & chunkData[index++])){
                     break;
                 }
             }
             if((index + metaEventLength) > length) return false;
-            evt.data.insert(evt.data.end(), &chunkData[index], &chunkData[index + metaEventLength]);
             index += metaEventLength;
-            events.push_back(std::move(evt));
+            track.AddEvent(deltaTime, status, &chunkData[start], index - start);
         }
     }
-    this->events.swap(events);
+    this->events.swap(track.events);
+    this->payload.swap(track.payload);
     return true;
 }
 
 bool MIDIChunkTrack::Encode(std::vector<uint8_t>& bytes){
+    uint8_t runningStatus = 0;
     for(auto&& event : events){
         uint32_t dt = 0x0FFFFFFF & event.deltaTime;
         uint8_t b3 = (0x0000007F & (dt >> 21));
@@ -162,25 +161,41 @@ bool MIDIChunkTrack::Encode(std::vector<uint8_t>& bytes){
             bytes.push_back(0x80 | b1);
         }
         bytes.push_back(b0);
-        bytes.push_back(event.status);
-        for(unsigned i = 0; i < (unsigned)event.data.size(); i++){
-            bytes.push_back(event.data[i]);
+
+        // Running status for channel messages, system and meta events cancel the running status, bytes below 0x80 are always written
+        if(!runningStatus || (event.status != runningStatus)){
+            bytes.push_back(event.status);
         }
+        runningStatus = ((event.status >= 0x80) && (event.status < 0xF0)) ? event.status : 0;
+        const uint8_t* data = GetData(event);
+        bytes.insert(bytes.end(), data, data + event.dataLength);
     }
     return true;
 }
 
+void MIDIChunkTrack::AddEvent(uint32_t deltaTime, uint8_t status, const uint8_t* data, uint32_t length){
+    if(length <= MIDI_EVENT_INLINE_DATA_SIZE){
+        events.push_back(MIDIEvent(deltaTime, status, data, length));
+        return;
+    }
+    events.push_back(MIDIEvent(deltaTime, status));
+    events.back().dataLength = length;
+    events.back().dataOffset = (uint32_t)payload.size();
+    payload.insert(payload.end(), data, data + length);
+}
+
 std::string MIDIChunkTrack::GetSequenceTrackName(void){
     std::string result;
     for(auto&& event : events){
-        if((0xFF == event.status) && (event.data.size() > 1) && (0x03 == event.data[0])){
+        if((0xFF == event.status) && (event.dataLength > 1) && (0x03 == GetData(event)[0])){
+            const uint8_t* data = GetData(event);
             uint32_t bytesRead;
-            uint32_t len = MIDIFile::ReadVariableLength(bytesRead, &event.data[1], (uint32_t)event.data.size() - 1);
-            if(event.data.size() != (1 + bytesRead + len)){
+            uint32_t len = MIDIFile::ReadVariableLength(bytesRead, &data[1], event.dataLength - 1);
+            if(event.dataLength != (1 + bytesRead + len)){
                 break;
             }
-            for(uint32_t k = 1 + bytesRead; k < event.data.size(); k++){
-                result.push_back((char)event.data[k]);
+            for(uint32_t k = 1 + bytesRead; k < event.dataLength; k++){
+                result.push_back((char)data[k]);
             }
             break;
         }
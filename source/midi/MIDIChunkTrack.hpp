@@ -6,7 +6,8 @@
 
 class MIDIChunkTrack {
     public:
-        std::vector<MIDIEvent> events;
+        std::vector<MIDIEvent> events;    ///< All events of the track.
+        std::vector<uint8_t> payload;     ///< Arena for data bytes of events that are not stored inline (sysex and meta events).
 
         /**
          *  \brief Decode chunk data of a track chunk.
@@ -17,12 +18,36 @@ class MIDIChunkTrack {
         bool Decode(const uint8_t* chunkData, const uint32_t length);
 
         /**
-         *  @brief Encode data chunk.
+         *  @brief Encode data chunk. Channel messages use running status.
          *  @param [out] bytes Container to which to append the encoded bytes.
          *  @return True if success, false otherwise.
          */
         bool Encode(std::vector<uint8_t>& bytes);
 
+        /**
+         *  @brief Append an event to the track.
+         *  @param [in] deltaTime Delta time of MIDI event.
+         *  @param [in] status Status byte of MIDI event.
+         *  @param [in] data Buffer containing the data of the MIDI event.
+         *  @param [in] length Number of data bytes. Data that does not fit inline is appended to the @ref payload arena.
+         */
+        void AddEvent(uint32_t deltaTime, uint8_t status, const uint8_t* data, uint32_t length);
+
+        /**
+         *  @brief Append an event to the track.
+         *  @param [in] deltaTime Delta time of MIDI event.
+         *  @param [in] status Status byte of MIDI event.
+         *  @param [in] data Data bytes of the MIDI event.
+         */
+        inline void AddEvent(uint32_t deltaTime, uint8_t status, std::initializer_list<uint8_t> data){ AddEvent(deltaTime, status, data.begin(), (uint32_t)data.size()); }
+
+        /**
+         *  @brief Get the data bytes of an event of this track.
+         *  @param [in] event An event of this track.
+         *  @return Pointer to @ref MIDIEvent::dataLength data bytes, either inside the event or inside the @ref payload arena.
+         */
+        inline const uint8_t* GetData(const MIDIEvent& event) const { return event.HasInlineData() ? &event.inlineData[0] : &payload[event.dataOffset]; }
+
         /**
          *  @brief Get the sequence or the track name.
          *  @return The sequence or track name.
@@ -4,17 +4,19 @@
 MIDIEvent::MIDIEvent(){
     deltaTime = 0;
     status = 0;
+    inlineData[0] = inlineData[1] = 0;
+    dataLength = 0;
+    dataOffset = 0;
     absoluteTicks = 0;
 }
 
-MIDIEvent::MIDIEvent(uint32_t deltaTime, uint8_t status){
+MIDIEvent::MIDIEvent(uint32_t deltaTime, uint8_t status): MIDIEvent(){
     this->deltaTime = deltaTime;
     this->status = status;
 }
 
-MIDIEvent::MIDIEvent(uint32_t deltaTime, uint8_t status, const uint8_t* data, const uint32_t datalen){
-    this->deltaTime = deltaTime;
-    this->status = status;
-    this->data.assign(data, data + datalen);
+MIDIEvent::MIDIEvent(uint32_t deltaTime, uint8_t status, const uint8_t* data, const uint32_t datalen): MIDIEvent(deltaTime, status){
+    this->dataLength = std::min(datalen, (uint32_t)MIDI_EVENT_INLINE_DATA_SIZE);
+    std::copy(data, data + this->dataLength, &this->inlineData[0]);
 }
 
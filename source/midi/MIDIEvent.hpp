@@ -1,12 +1,17 @@
 #pragma once
 
 
+#define MIDI_EVENT_INLINE_DATA_SIZE   (2)   ///< Maximum number of data bytes that are stored inside the event itself (covers all channel voice messages).
+
+
 class MIDIEvent {
     public:
-        uint32_t deltaTime;          ///< Delta time that has to elapse after the previous event before this event happens. The format depends on the division attribute of the MIDI header (either ticks per quarter-node or SMPTE timecode).
-        uint8_t status;              ///< Status byte of the event. For meta events this will be 0xFF and @ref data will contain the remaining bytes of the event.
-        std::vector<uint8_t> data;   ///< Data bytes of the event.
-        uint64_t absoluteTicks;      ///< This value is not part of the event and is computed from delta times of all previous events (ticks per quarter-note format only).
+        uint32_t deltaTime;                                  ///< Delta time that has to elapse after the previous event before this event happens. The format depends on the division attribute of the MIDI header (either ticks per quarter-node or SMPTE timecode).
+        uint8_t status;                                      ///< Status byte of the event. For meta events this will be 0xFF and the data will contain the remaining bytes of the event.
+        uint8_t inlineData[MIDI_EVENT_INLINE_DATA_SIZE];     ///< Data bytes of the event if @ref dataLength is not greater than @ref MIDI_EVENT_INLINE_DATA_SIZE.
+        uint32_t dataLength;                                 ///< Number of data bytes of the event.
+        uint32_t dataOffset;                                 ///< Offset to the payload arena of the track chunk if the data is not stored inline (sysex and meta events).
+        uint64_t absoluteTicks;                              ///< This value is not part of the event and is computed from delta times of all previous events (ticks per quarter-note format only).
 
         /**
          *  @brief Create an empty MIDI event.
@@ -21,12 +26,18 @@ class MIDIEvent {
         MIDIEvent(uint32_t deltaTime, uint8_t status);
 
         /**
-         *  @brief Create a MIDI event.
+         *  @brief Create a MIDI event with inline data.
          *  @param [in] deltaTime Delta time of MIDI event.
          *  @param [in] status Status byte of MIDI event.
          *  @param [in] data Buffer containing the data of the MIDI event.
-         *  @param [in] datalen Actual length of the MIDI event data.
+         *  @param [in] datalen Actual length of the MIDI event data, must not be greater than @ref MIDI_EVENT_INLINE_DATA_SIZE.
          */
         MIDIEvent(uint32_t deltaTime, uint8_t status, const uint8_t* data, const uint32_t datalen);
+
+        /**
+         *  @brief Check whether the data bytes are stored inside the event.
+         *  @return True if data is stored in @ref inlineData, false if it is stored in the payload arena of the track chunk.
+         */
+        inline bool HasInlineData(void) const { return (dataLength <= MIDI_EVENT_INLINE_DATA_SIZE); }
 };
 
@@ -1,78 +1,134 @@
 #include <MIDIFile.hpp>
+#include <MIDIFileWriter.hpp>
 
 
 bool MIDIFile::Read(std::string filename){
-    std::ifstream file(filename, std::ios::binary);
-    file.unsetf(std::ios::skipws);
-    if(!file.is_open())
+    #ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(INVALID_HANDLE_VALUE == file)
         return false;
-    file.seekg(0, std::ios::end);
-    std::streampos fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
-    std::vector<uint8_t> bytes;
-    bytes.reserve(fileSize);
-    bytes.insert(bytes.begin(), std::istream_iterator<uint8_t>(file), std::istream_iterator<uint8_t>());
-    return this->Read(bytes);
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart <= 0)){
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(!mapping){
+        CloseHandle(file);
+        return false;
+    }
+    const uint8_t* bytes = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    bool result = bytes && this->Read(bytes, (size_t)fileSize.QuadPart);
+    if(bytes){
+        UnmapViewOfFile(bytes);
+    }
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return result;
+    #else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    struct stat fileStatus;
+    if(fstat(fd, &fileStatus) || (fileStatus.st_size <= 0)){
+        close(fd);
+        return false;
+    }
+    size_t fileSize = (size_t)fileStatus.st_size;
+    void* region = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(MAP_FAILED == region)
+        return false;
+    (void) madvise(region, fileSize, MADV_SEQUENTIAL);
+    bool result = this->Read((const uint8_t*)region, fileSize);
+    munmap(region, fileSize);
+    return result;
+    #endif
 }
 
 bool MIDIFile::Read(std::vector<uint8_t>& bytes){
+    return this->Read(bytes.data(), bytes.size());
+}
+
+bool MIDIFile::Read(const uint8_t* bytes, size_t length){
     // First chunk must be a header chunk "MThd"
     tracks.clear();
-    if(bytes.size() < 14) return false;
+    if(length < 14) return false;
     if(0x4D546864 != ((uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]))) return false;
     if(0x00000006 != ((uint32_t(bytes[4]) << 24) | (uint32_t(bytes[5]) << 16) | (uint32_t(bytes[6]) << 8) | uint32_t(bytes[7]))) return false;
     if(!header.Decode(&bytes[8], 6)) return false;
 
-    // Decode track chunks
+    // Scan offsets and lengths of all track chunks
+    std::vector<std::pair<size_t, uint32_t>> trackChunks;
     size_t index = 14;
-    while((index + 7) < bytes.size()){
+    while((index + 7) < length){
         uint32_t fourCC = (uint32_t(bytes[index]) << 24) | (uint32_t(bytes[index + 1]) << 16) | (uint32_t(bytes[index + 2]) << 8) | uint32_t(bytes[index + 3]);
-        uint32_t length = (uint32_t(bytes[index + 4]) << 24) | (uint32_t(bytes[index + 5]) << 16) | (uint32_t(bytes[index + 6]) << 8) | uint32_t(bytes[index + 7]);
+        uint32_t chunkLength = (uint32_t(bytes[index + 4]) << 24) | (uint32_t(bytes[index + 5]) << 16) | (uint32_t(bytes[index + 6]) << 8) | uint32_t(bytes[index + 7]);
         index += 8;
-        if((index + size_t(length)) > bytes.size()){
-            tracks.clear();
+        if((index + size_t(chunkLength)) > length){
             return false;
         }
         // "MTrk"
         if(0x4D54726B == fourCC){
-            MIDIChunkTrack track;
-            if(!track.Decode(&bytes[index], length)){
-                tracks.clear();
-                return false;
-            }
-            tracks.push_back(std::move(track));
+            trackChunks.push_back(std::make_pair(index, chunkLength));
         }
         // Alien chunks are ignored
-        index += (size_t)length;
+        index += (size_t)chunkLength;
     }
 
     // Check if header was right
-    if(header.numTracks != (uint32_t)tracks.size()){
-        tracks.clear();
+    if(header.numTracks != (uint32_t)trackChunks.size()){
         return false;
     }
 
-    // Compute absolute ticks (ticks per quarter-note format only)
-    if(!(0x8000 & header.division)){
-        for(auto&& track : tracks){
-            uint64_t t = 0;
-            for(auto&& e : track.events){
-                e.absoluteTicks = (t += (uint64_t)e.deltaTime);
+    // Decode track chunks and compute absolute ticks (ticks per quarter-note format only), each worker takes the next pending track
+    tracks.resize(trackChunks.size());
+    const bool computeAbsoluteTicks = !(0x8000 & header.division);
+    std::atomic<size_t> next(0);
+    std::atomic<bool> success(true);
+    auto worker = [&](){
+        for(size_t n = next++; (n < trackChunks.size()) && success; n = next++){
+            if(!tracks[n].Decode(&bytes[trackChunks[n].first], trackChunks[n].second)){
+                success = false;
+                break;
+            }
+            if(computeAbsoluteTicks){
+                uint64_t t = 0;
+                for(auto&& e : tracks[n].events){
+                    e.absoluteTicks = (t += (uint64_t)e.deltaTime);
+                }
             }
         }
+    };
+    uint32_t numThreads = std::min((uint32_t)trackChunks.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> workers;
+    for(uint32_t t = 1; t < numThreads; t++){
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for(auto&& w : workers){
+        w.join();
+    }
+    if(!success){
+        tracks.clear();
+        return false;
     }
     return true;
 }
 
 bool MIDIFile::Write(std::string filename){
-    std::vector<uint8_t> bytes;
-    if(!this->Write(bytes))
+    if((uint16_t)tracks.size() != header.numTracks){
+        LogError("MISMATCH!\n");
         return false;
-    std::ofstream file(filename, std::ios::out | std::ios::binary);
-    if(!file.is_open())
+    }
+    MIDIFileWriter writer;
+    if(!writer.Open(filename))
         return false;
-    file.write((char*)&bytes[0],bytes.size());
-    return true;
+    bool success = writer.WriteHeader(header);
+    for(size_t n = 0; success && (n < tracks.size()); n++){
+        success = writer.WriteTrack(tracks[n]);
+    }
+    return writer.Close() && success;
 }
 
 bool MIDIFile::Write(std::vector<uint8_t>& bytes){
@@ -96,23 +152,23 @@ bool MIDIFile::Write(std::vector<uint8_t>& bytes){
         return false;
     }
 
-    // Data chunks
+    // Data chunks are encoded in place, the chunk length is patched afterwards
     for(auto&& track : tracks){
-        std::vector<uint8_t> chunkData;
-        if(!track.Encode(chunkData)){
-            bytes.clear();
-            return false;
-        }
         bytes.push_back(0x4D);
         bytes.push_back(0x54);
         bytes.push_back(0x72);
         bytes.push_back(0x6B);
-        uint32_t length = (uint32_t)chunkData.size();
-        bytes.push_back((uint8_t)(0x000000FF & (length >> 24)));
-        bytes.push_back((uint8_t)(0x000000FF & (length >> 16)));
-        bytes.push_back((uint8_t)(0x000000FF & (length >> 8)));
-        bytes.push_back((uint8_t)(0x000000FF & length));
-        bytes.insert(bytes.end(), chunkData.begin(), chunkData.end());
+        size_t start = bytes.size();
+        bytes.resize(start + 4);
+        if(!track.Encode(bytes)){
+            bytes.clear();
+            return false;
+        }
+        uint32_t length = (uint32_t)(bytes.size() - start - 4);
+        bytes[start] = (uint8_t)(0x000000FF & (length >> 24));
+        bytes[start + 1] = (uint8_t)(0x000000FF & (length >> 16));
+        bytes[start + 2] = (uint8_t)(0x000000FF & (length >> 8));
+        bytes[start + 3] = (uint8_t)(0x000000FF & length);
     }
     return true;
 }
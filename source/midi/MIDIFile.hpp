@@ -14,6 +14,7 @@ class MIDIFile {
          *  \brief Read MIDI data from MIDI file.
          *  \param [in] filename Name of the MIDI file to read.
          *  \return True if success, false otherwise.
+         *  \details The file is memory-mapped and decoded directly from the mapped region.
          */
         bool Read(std::string filename);
 
@@ -24,10 +25,20 @@ class MIDIFile {
          */
         bool Read(std::vector<uint8_t>& bytes);
 
+        /**
+         *  \brief Read MIDI data from binary data of MIDI file.
+         *  \param [in] bytes Pointer to binary MIDI file data. The data is decoded in place and is not copied.
+         *  \param [in] length Number of bytes.
+         *  \return True if success, false otherwise.
+         *  \details Chunk boundaries are scanned first, then all track chunks are decoded in parallel.
+         */
+        bool Read(const uint8_t* bytes, size_t length);
+
         /**
          *  @brief Write MIDI data to a MIDI file.
          *  @param [in] filename Name of the MIDI file to write.
          *  @return True if success, false otherwise.
+         *  @details The file is streamed by a @ref MIDIFileWriter, the encoded tracks are not kept in memory.
          */
         bool Write(std::string filename);
 
@@ -0,0 +1,189 @@
+#include <MIDIFileWriter.hpp>
+
+
+MIDIFileWriter::MIDIFileWriter(){
+    #ifdef _WIN32
+    file = INVALID_HANDLE_VALUE;
+    #else
+    fd = -1;
+    #endif
+    buffer.resize(MIDI_FILE_WRITER_BUFFER_SIZE);
+    numBuffered = 0;
+    position = 0;
+    trackPosition = 0;
+    runningStatus = 0;
+    good = false;
+}
+
+MIDIFileWriter::~MIDIFileWriter(){
+    (void) Close();
+}
+
+bool MIDIFileWriter::Open(std::string filename){
+    (void) Close();
+    #ifdef _WIN32
+    file = CreateFileA(filename.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    #else
+    fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    #endif
+    if(!IsOpen()){
+        LogError("Could not open file \"%s\"!\n", filename.c_str());
+        return false;
+    }
+    numBuffered = 0;
+    position = 0;
+    trackPosition = 0;
+    runningStatus = 0;
+    good = true;
+    return true;
+}
+
+bool MIDIFileWriter::WriteHeader(const MIDIChunkHeader& header){
+    const uint8_t bytes[14] = {
+        0x4D, 0x54, 0x68, 0x64, 0x00, 0x00, 0x00, 0x06,
+        (uint8_t)(header.format >> 8), (uint8_t)header.format,
+        (uint8_t)(header.numTracks >> 8), (uint8_t)header.numTracks,
+        (uint8_t)(header.division >> 8), (uint8_t)header.division
+    };
+    Put(&bytes[0], sizeof(bytes));
+    return good;
+}
+
+bool MIDIFileWriter::BeginTrack(void){
+    const uint8_t bytes[8] = {0x4D, 0x54, 0x72, 0x6B, 0x00, 0x00, 0x00, 0x00};
+    Put(&bytes[0], sizeof(bytes));
+    trackPosition = position - 4;
+    runningStatus = 0;
+    return good;
+}
+
+bool MIDIFileWriter::WriteEvent(uint32_t deltaTime, uint8_t status, const uint8_t* data, uint32_t length){
+    // Variable length delta time
+    uint8_t bytes[5];
+    uint32_t n = 0;
+    uint32_t dt = 0x0FFFFFFF & deltaTime;
+    if(dt > 0x001FFFFF){
+        bytes[n++] = 0x80 | (uint8_t)(0x0000007F & (dt >> 21));
+    }
+    if(dt > 0x00003FFF){
+        bytes[n++] = 0x80 | (uint8_t)(0x0000007F & (dt >> 14));
+    }
+    if(dt > 0x0000007F){
+        bytes[n++] = 0x80 | (uint8_t)(0x0000007F & (dt >> 7));
+    }
+    bytes[n++] = (uint8_t)(0x0000007F & dt);
+
+    // Running status for channel messages, system and meta events cancel the running status, bytes below 0x80 are always written
+    if(!runningStatus || (status != runningStatus)){
+        bytes[n++] = status;
+    }
+    runningStatus = ((status >= 0x80) && (status < 0xF0)) ? status : 0;
+    Put(&bytes[0], n);
+    Put(data, length);
+    return good;
+}
+
+bool MIDIFileWriter::EndTrack(void){
+    uint64_t trackLength = position - trackPosition - 4;
+    if(trackLength > 0xFFFFFFFF){
+        LogError("Track chunk exceeds the maximum length!\n");
+        good = false;
+        return false;
+    }
+    Flush();
+    if(!good){
+        return false;
+    }
+    uint32_t length = (uint32_t)trackLength;
+    const uint8_t bytes[4] = {(uint8_t)(length >> 24), (uint8_t)(length >> 16), (uint8_t)(length >> 8), (uint8_t)length};
+    #ifdef _WIN32
+    LARGE_INTEGER offset;
+    offset.QuadPart = (LONGLONG)trackPosition;
+    DWORD numWritten = 0;
+    LARGE_INTEGER end;
+    end.QuadPart = 0;
+    good = SetFilePointerEx(file, offset, NULL, FILE_BEGIN) && ::WriteFile(file, &bytes[0], 4, &numWritten, NULL) && (4 == numWritten) && SetFilePointerEx(file, end, NULL, FILE_END);
+    #else
+    good = (4 == pwrite(fd, &bytes[0], 4, (off_t)trackPosition));
+    #endif
+    runningStatus = 0;
+    return good;
+}
+
+bool MIDIFileWriter::WriteTrack(const MIDIChunkTrack& track){
+    (void) BeginTrack();
+    for(auto&& event : track.events){
+        (void) WriteEvent(event.deltaTime, event.status, track.GetData(event), event.dataLength);
+    }
+    return EndTrack();
+}
+
+bool MIDIFileWriter::Close(void){
+    if(!IsOpen()){
+        return false;
+    }
+    Flush();
+    #ifdef _WIN32
+    CloseHandle(file);
+    file = INVALID_HANDLE_VALUE;
+    #else
+    if(close(fd)){
+        good = false;
+    }
+    fd = -1;
+    #endif
+    return good;
+}
+
+void MIDIFileWriter::Put(const uint8_t* bytes, size_t length){
+    position += (uint64_t)length;
+    while(length){
+        size_t n = std::min(length, buffer.size() - numBuffered);
+        std::memcpy(&buffer[numBuffered], bytes, n);
+        numBuffered += n;
+        bytes += n;
+        length -= n;
+        if(numBuffered == buffer.size()){
+            Flush();
+        }
+    }
+}
+
+void MIDIFileWriter::Flush(void){
+    if(numBuffered){
+        WriteBytes(&buffer[0], numBuffered);
+        numBuffered = 0;
+    }
+}
+
+void MIDIFileWriter::WriteBytes(const uint8_t* bytes, size_t length){
+    while(good && length){
+        #ifdef _WIN32
+        DWORD numWritten = 0;
+        if(!::WriteFile(file, bytes, (DWORD)std::min(length, (size_t)0x40000000), &numWritten, NULL) || !numWritten){
+            good = false;
+            break;
+        }
+        #else
+        ssize_t numWritten = write(fd, bytes, length);
+        if(numWritten < 0){
+            if(EINTR == errno){
+                continue;
+            }
+            good = false;
+            break;
+        }
+        #endif
+        bytes += (size_t)numWritten;
+        length -= (size_t)numWritten;
+    }
+}
+
+bool MIDIFileWriter::IsOpen(void){
+    #ifdef _WIN32
+    return (INVALID_HANDLE_VALUE != file);
+    #else
+    return (fd >= 0);
+    #endif
+}
+
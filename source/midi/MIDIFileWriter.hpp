@@ -0,0 +1,125 @@
+#pragma once
+
+
+#include <MIDIChunkHeader.hpp>
+#include <MIDIChunkTrack.hpp>
+
+
+#define MIDI_FILE_WRITER_BUFFER_SIZE   (65536)   ///< Size of the write buffer in bytes.
+
+
+/**
+ *  @brief Class: MIDIFileWriter
+ *  @details Streams a standard MIDI file directly to a file through a fixed buffer. Events are written one after another, the
+ *  length of a track chunk is patched when the track is ended, so neither the events nor the encoded track have to be kept in memory.
+ *  Channel messages use running status, the status byte is omitted if it equals the status byte of the previous event.
+ */
+class MIDIFileWriter {
+    public:
+        /**
+         *  @brief Create a MIDI file writer.
+         */
+        MIDIFileWriter();
+
+        /**
+         *  @brief Close the MIDI file.
+         */
+        ~MIDIFileWriter();
+
+        /**
+         *  @brief Create a new MIDI file.
+         *  @param [in] filename The filename of the MIDI file, an existing file is overwritten.
+         *  @return True if success, false otherwise.
+         */
+        bool Open(std::string filename);
+
+        /**
+         *  @brief Write the header chunk.
+         *  @param [in] header The header chunk.
+         *  @return True if success, false otherwise.
+         */
+        bool WriteHeader(const MIDIChunkHeader& header);
+
+        /**
+         *  @brief Begin a new track chunk. The chunk length is written as zero and is patched by @ref EndTrack.
+         *  @return True if success, false otherwise.
+         */
+        bool BeginTrack(void);
+
+        /**
+         *  @brief Write an event to the current track chunk.
+         *  @param [in] deltaTime Delta time of MIDI event.
+         *  @param [in] status Status byte of MIDI event.
+         *  @param [in] data Buffer containing the data of the MIDI event.
+         *  @param [in] length Number of data bytes.
+         *  @return True if success, false otherwise.
+         */
+        bool WriteEvent(uint32_t deltaTime, uint8_t status, const uint8_t* data, uint32_t length);
+
+        /**
+         *  @brief Write an event to the current track chunk.
+         *  @param [in] deltaTime Delta time of MIDI event.
+         *  @param [in] status Status byte of MIDI event.
+         *  @param [in] data Data bytes of the MIDI event.
+         *  @return True if success, false otherwise.
+         */
+        inline bool WriteEvent(uint32_t deltaTime, uint8_t status, std::initializer_list<uint8_t> data){ return WriteEvent(deltaTime, status, data.begin(), (uint32_t)data.size()); }
+
+        /**
+         *  @brief Patch the length of the current track chunk.
+         *  @return True if success, false otherwise.
+         */
+        bool EndTrack(void);
+
+        /**
+         *  @brief Write a complete track chunk.
+         *  @param [in] track The track chunk.
+         *  @return True if success, false otherwise.
+         */
+        bool WriteTrack(const MIDIChunkTrack& track);
+
+        /**
+         *  @brief Flush the buffer and close the MIDI file.
+         *  @return True if all data has been written successfully, false otherwise.
+         */
+        bool Close(void);
+
+    private:
+        #ifdef _WIN32
+        HANDLE file;                    ///< Handle of the MIDI file.
+        #else
+        int fd;                         ///< File descriptor of the MIDI file.
+        #endif
+        std::vector<uint8_t> buffer;    ///< Write buffer of fixed size.
+        size_t numBuffered;             ///< Number of bytes in the write buffer.
+        uint64_t position;              ///< Number of bytes written so far (including buffered bytes).
+        uint64_t trackPosition;         ///< Position of the chunk length of the current track chunk.
+        uint8_t runningStatus;          ///< Status byte of the previous channel message, zero if there is none.
+        bool good;                      ///< False if an error occurred.
+
+        /**
+         *  @brief Append bytes to the write buffer and flush the buffer if it is full.
+         *  @param [in] bytes The bytes to be written.
+         *  @param [in] length Number of bytes.
+         */
+        void Put(const uint8_t* bytes, size_t length);
+
+        /**
+         *  @brief Write the content of the write buffer to the file.
+         */
+        void Flush(void);
+
+        /**
+         *  @brief Write bytes directly to the file.
+         *  @param [in] bytes The bytes to be written.
+         *  @param [in] length Number of bytes.
+         */
+        void WriteBytes(const uint8_t* bytes, size_t length);
+
+        /**
+         *  @brief Check whether a file is open.
+         *  @return True if a file is open, false otherwise.
+         */
+        bool IsOpen(void);
+};
+
@@ -11,6 +11,8 @@
 #include <iterator>
 #include <fstream>
 #include <cstdio>
+#include <cstring>
+#include <cerrno>
 #include <cmath>
 #include <chrono>
 #include <vector>
@@ -21,6 +23,11 @@
 #include <future>
 #include <atomic>
 #include <set>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <array>
+#include <condition_variable>
 #include <functional>
 #include <numeric>
 #include <regex>
@@ -34,6 +41,9 @@
 #include <sys/types.h>
 #include <dirent.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #endif /* _WIN32 */
 
 /* OpenGL and utilities */
@@ -67,6 +77,8 @@
 #define WINDOW_TITLE            "CKeys"
 #define WINDOW_INITIAL_WIDTH    (960)
 #define WINDOW_INITIAL_HEIGHT   (540)
+#define WINDOW_IDLE_TIMEOUT     (0.5)   // Maximum time in seconds to wait for events if nothing has to be animated.
+#define WINDOW_DEFAULT_REFRESH  (60)    // Refresh rate in Hz if the refresh rate of the monitor is unknown.
 
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -0,0 +1,170 @@
+/**
+ *  @brief Zero-allocation test for the capture path of the recorder.
+ *  @details A producer thread plays the role of the MIDI thread and passes messages at 10 kHz to MIDICapture::Capture, the capture path
+ *  of Recorder::ReceiveMIDI, while a second thread plays the role of the render thread and the journal writer: it calls NoteLog::Reserve
+ *  once per frame and drains the record log. The global allocation functions are replaced by counting versions, the test fails if the producer thread
+ *  allocates memory, if a chunk had to be allocated by the producer or if a message is lost.
+ */
+#include <MIDICapture.hpp>
+
+
+#define TEST_MESSAGE_RATE      (10000)   ///< Number of MIDI messages per second.
+#define TEST_DURATION          (3)       ///< Duration of the test in seconds.
+#define TEST_FRAME_PERIOD      (16)      ///< Period of the render thread in milliseconds.
+#define TEST_NUM_LANES         (4)       ///< Number of lanes that are played, few lanes make the producer cross many chunks.
+#define TEST_SYSEX_PERIOD      (500)     ///< Every n-th message is a sysex message.
+#define TEST_SYSEX_SIZE        (64)      ///< Number of bytes of a sysex message.
+
+
+static thread_local bool countAllocations = false;  ///< True for the producer thread while it is measured.
+static std::atomic<uint32_t> numAllocations(0);      ///< Number of allocations of the producer thread.
+
+
+static void* Allocate(size_t size){
+    if(countAllocations){
+        numAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* p = std::malloc(size ? size : 1);
+    if(!p){
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(size_t size){ return Allocate(size); }
+void* operator new[](size_t size){ return Allocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { try{ return Allocate(size); } catch(...){ return nullptr; } }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { try{ return Allocate(size); } catch(...){ return nullptr; } }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t num, size_t size);
+extern "C" void* __libc_realloc(void* p, size_t size);
+extern "C" void* malloc(size_t size){
+    if(countAllocations){
+        numAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return __libc_malloc(size);
+}
+extern "C" void* calloc(size_t num, size_t size){
+    if(countAllocations){
+        numAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return __libc_calloc(num, size);
+}
+extern "C" void* realloc(void* p, size_t size){
+    if(countAllocations){
+        numAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return __libc_realloc(p, size);
+}
+#endif
+
+
+/**
+ *  @brief Get the message bytes of the n-th message that is sent by the producer.
+ *  @param [in] n Index of the message.
+ *  @param [out] bytes Buffer for at least @ref TEST_SYSEX_SIZE bytes.
+ *  @return Number of message bytes.
+ */
+static uint32_t GetMessage(uint32_t n, uint8_t* bytes){
+    if(!(n % TEST_SYSEX_PERIOD)){
+        bytes[0] = 0xF0;
+        for(uint32_t i = 1; i < (TEST_SYSEX_SIZE - 1); i++){
+            bytes[i] = (uint8_t)((n + i) & 0x7F);
+        }
+        bytes[TEST_SYSEX_SIZE - 1] = 0xF7;
+        return TEST_SYSEX_SIZE;
+    }
+    // Note on, followed by a note on with zero velocity that uses running status
+    if(n & 1){
+        bytes[0] = (uint8_t)(21 + ((n / 2) % TEST_NUM_LANES));
+        bytes[1] = 0x00;
+        return 2;
+    }
+    bytes[0] = 0x90;
+    bytes[1] = (uint8_t)(21 + ((n / 2) % TEST_NUM_LANES));
+    bytes[2] = (uint8_t)(1 + (n % 127));
+    return 3;
+}
+
+
+int main(){
+    NoteLog notes;
+    MIDIRecordLog log;
+    MIDICapture::State state;
+    notes.Reserve();
+
+    // Make sure that allocations are counted at all
+    countAllocations = true;
+    delete (new int(0));
+    countAllocations = false;
+    if(!numAllocations.exchange(0)){
+        fprintf(stderr, "allocation functions are not replaced\n");
+        printf("FAILED\n");
+        return 1;
+    }
+
+    // Render thread and journal writer: reserve notes once per frame and drain the record log
+    const uint32_t numMessages = TEST_MESSAGE_RATE * TEST_DURATION;
+    std::atomic<bool> running(true);
+    uint32_t numConsumed = 0;
+    uint32_t numCorrupted = 0;
+    std::thread consumer([&](){
+        uint8_t expected[TEST_SYSEX_SIZE];
+        for(bool stop = false; !stop;){
+            stop = !running.load();
+            notes.Reserve();
+            size_t size = log.GetSize();
+            for(; numConsumed < size; numConsumed++){
+                const MIDIRecordLog::Record& record = log.Get(numConsumed);
+                uint32_t length = GetMessage(numConsumed, expected);
+                bool equal = (record.length == length);
+                for(uint32_t i = 0; equal && (i < length); i++){
+                    equal = (log.GetByte(record, i) == expected[i]);
+                }
+                numCorrupted += equal ? 0 : 1;
+            }
+            log.Consume(size);
+            std::this_thread::sleep_for(std::chrono::milliseconds(TEST_FRAME_PERIOD));
+        }
+    });
+
+    // MIDI thread: send messages at a fixed rate, every note off is followed by a note on of the next lane
+    std::thread producer([&](){
+        uint8_t bytes[TEST_SYSEX_SIZE];
+        auto timeOfStart = std::chrono::steady_clock::now();
+        countAllocations = true;
+        for(uint32_t n = 0; n < numMessages; n++){
+            std::this_thread::sleep_until(timeOfStart + std::chrono::microseconds((uint64_t)n * 1000000 / TEST_MESSAGE_RATE));
+            uint32_t length = GetMessage(n, bytes);
+            MIDICapture::Capture(notes, log, state, (double)n / (double)TEST_MESSAGE_RATE, 1.0 / (double)TEST_MESSAGE_RATE, bytes, length);
+        }
+        countAllocations = false;
+    });
+    producer.join();
+    running = false;
+    consumer.join();
+
+    // Every note on message that is not replaced by a sysex message is a note
+    size_t numNotes = 0;
+    size_t numExpectedNotes = 0;
+    for(int k = 0; k < 88; k++){
+        numNotes += notes.GetSize(k);
+    }
+    for(uint32_t n = 0; n < numMessages; n += 2){
+        numExpectedNotes += (n % TEST_SYSEX_PERIOD) ? 1 : 0;
+    }
+
+    uint32_t numFallbackAllocations = notes.GetNumFallbackAllocations();
+    uint32_t numDropped = state.numDroppedMessages.load() + state.numDroppedNotes.load();
+    printf("%u messages, %zu notes: %u allocations, %u fallback allocations, %u dropped, %u consumed, %u corrupted\n", numMessages, numNotes, numAllocations.load(), numFallbackAllocations, numDropped, numConsumed, numCorrupted);
+    bool success = !numAllocations.load() && !numFallbackAllocations && !numDropped && !numCorrupted && (numMessages == numConsumed) && (numExpectedNotes == numNotes);
+    printf(success ? "PASSED\n" : "FAILED\n");
+    return success ? 0 : 1;
+}
+
@@ -0,0 +1,268 @@
+/**
+ *  @brief Regression test for SequenceTrack::GenerateLanes.
+ *  @details The note blocks of all lanes are compared against the original quadratic implementation that clamps the off time of every
+ *  previous block of a lane on each note off. The corpus consists of generated MIDI files (regular notes, missing and duplicated note offs,
+ *  note on events with velocity zero, sustain pedal and tempo changes) and of all MIDI files that are passed as command line arguments.
+ */
+#include <SequenceTrack.hpp>
+#include <MIDIFile.hpp>
+
+
+/**
+ *  @brief Class: ReferenceTrack
+ *  @details Sequence track that is loaded the same way as by Sequencer::ReadMIDIFile and that contains the reference implementation.
+ */
+class ReferenceTrack: public SequenceTrack {
+    public:
+        /**
+         *  @brief Load the note events of a channel of a MIDI track and the sustain pedal changes of that channel of all MIDI tracks.
+         *  @param [in] midi The MIDI file.
+         *  @param [in] n Index of the MIDI track.
+         *  @param [in] channel The MIDI channel.
+         *  @return True if the track contains note events, false otherwise.
+         */
+        bool Load(const MIDIFile& midi, size_t n, uint8_t channel){
+            midiEvents.clear();
+            sustainPedalChanges.clear();
+            for(auto&& event : midi.tracks[n].events){
+                if(((0x80 == (0xF0 & event.status)) || (0x90 == (0xF0 & event.status))) && (channel == (event.status & 0x0F))){
+                    midiEvents.push_back(event);
+                }
+            }
+            for(size_t m = (0 == midi.header.format) ? 0 : 1; m < midi.tracks.size(); m++){
+                for(auto&& event : midi.tracks[m].events){
+                    if((0xB0 == (0xF0 & event.status)) && (2 == event.dataLength) && (0x40 == event.inlineData[0]) && (channel == (event.status & 0x0F))){
+                        sustainPedalChanges.push_back({event.absoluteTicks, (event.inlineData[1] >= 64)});
+                    }
+                }
+            }
+            std::stable_sort(sustainPedalChanges.begin(), sustainPedalChanges.end(), [](const std::pair<uint64_t, bool>& a, const std::pair<uint64_t, bool>& b){ return a.first < b.first; });
+            return !midiEvents.empty();
+        }
+
+        /**
+         *  @brief Generate the note blocks of all lanes with the original quadratic implementation.
+         *  @param [in] tempoMap The tempo map that converts ticks to seconds.
+         *  @param [in] timeScale Scale factor for all times.
+         */
+        void GenerateReferenceLanes(const TempoMap& tempoMap, double timeScale){
+            for(int i = 0; i < 88; i++){
+                lanes[i].clear();
+            }
+            auto getTimestampOfNextPedalOff = [&](uint64_t tick){
+                for(auto&& pc : sustainPedalChanges){
+                    if((pc.first > tick) && !pc.second){
+                        return tempoMap.GetTimestamp(pc.first);
+                    }
+                }
+                return std::numeric_limits<double>::infinity();
+            };
+            auto isPedalPressed = [&](uint64_t tick){
+                bool pressed = false;
+                for(auto&& pc : sustainPedalChanges){
+                    if(pc.first > tick){
+                        break;
+                    }
+                    pressed = pc.second;
+                }
+                return pressed;
+            };
+            for(auto&& me : midiEvents){
+                uint8_t key = me.inlineData[0];
+                if((2 != me.dataLength) || (key < 21) || (key > 108)){
+                    continue;
+                }
+                key -= 21;
+                bool noteOn = (0x90 == (0xF0 & me.status)) && (me.inlineData[1] & 0x7F);
+                if(noteOn){
+                    lanes[key].push_back(NoteBlock(double(me.inlineData[1] & 0x7F) / 127.0, timeScale * tempoMap.GetTimestamp(me.absoluteTicks)));
+                    continue;
+                }
+                double timeOff = timeScale * tempoMap.GetTimestamp(me.absoluteTicks);
+                if(lanes[key].size()){
+                    lanes[key].back().sustainOff = lanes[key].back().off = std::min(lanes[key].back().off, timeOff);
+                    if(isPedalPressed(me.absoluteTicks)){
+                        lanes[key].back().sustainOff = timeScale * getTimestampOfNextPedalOff(me.absoluteTicks);
+                    }
+                }
+                int32_t N = (int32_t)lanes[key].size();
+                for(int32_t n = N - 1; n >= 0; --n){
+                    lanes[key][n].off = std::min(lanes[key][n].off, timeOff);
+                }
+            }
+        }
+};
+
+
+/**
+ *  @brief Simple deterministic pseudo random number generator.
+ */
+class Random {
+    public:
+        explicit Random(uint32_t seed):state(seed){}
+        uint32_t Next(uint32_t range){ state = state * 1664525u + 1013904223u; return (state >> 8) % range; }
+    private:
+        uint32_t state;
+};
+
+
+/**
+ *  @brief Generate a MIDI file in memory.
+ *  @param [in] seed Seed of the random number generator.
+ *  @param [in] numTracks Number of instrument tracks.
+ *  @param [in] numEvents Number of events per instrument track.
+ *  @param [in] probabilityMissingOff Probability in percent that a note off event is dropped.
+ *  @param [in] probabilityDuplicate Probability in percent that a note on or note off event is sent twice.
+ *  @param [in] pedal True if sustain pedal changes should be generated.
+ *  @return Binary data of the MIDI file.
+ */
+static std::vector<uint8_t> GenerateMIDIFile(uint32_t seed, uint16_t numTracks, uint32_t numEvents, uint32_t probabilityMissingOff, uint32_t probabilityDuplicate, bool pedal){
+    Random random(seed);
+    MIDIFile midi;
+    midi.header.format = 1;
+    midi.header.numTracks = numTracks + 1;
+    midi.header.division = 480;
+
+    // Info track with tempo changes
+    midi.tracks.push_back(MIDIChunkTrack());
+    midi.tracks.back().AddEvent(0, 0xFF, {0x51, 0x03, 0x07, 0xA1, 0x20});
+    for(int i = 0; i < 8; i++){
+        uint32_t usPerQuarter = 300000 + random.Next(500000);
+        midi.tracks.back().AddEvent(random.Next(20000), 0xFF, {0x51, 0x03, (uint8_t)(usPerQuarter >> 16), (uint8_t)(usPerQuarter >> 8), (uint8_t)usPerQuarter});
+    }
+    midi.tracks.back().AddEvent(0, 0xFF, {0x2F, 0x00});
+
+    // Instrument tracks
+    for(uint16_t t = 0; t < numTracks; t++){
+        midi.tracks.push_back(MIDIChunkTrack());
+        MIDIChunkTrack& track = midi.tracks.back();
+        uint8_t channel = (uint8_t)(t % 16);
+        std::vector<uint8_t> activeKeys;
+        for(uint32_t e = 0; e < numEvents; e++){
+            uint32_t deltaTime = random.Next(4) ? random.Next(240) : 0;
+            uint32_t action = random.Next(100);
+            if(pedal && (action < 5)){
+                track.AddEvent(deltaTime, 0xB0 | channel, {0x40, (uint8_t)(random.Next(2) ? 127 : 0)});
+            }
+            else if((action < 55) || activeKeys.empty()){
+                uint8_t key = (uint8_t)(15 + random.Next(100));
+                uint8_t velocity = (uint8_t)(1 + random.Next(127));
+                track.AddEvent(deltaTime, 0x90 | channel, {key, velocity});
+                if(random.Next(100) < probabilityDuplicate){
+                    track.AddEvent(random.Next(2) ? 0 : random.Next(60), 0x90 | channel, {key, velocity});
+                }
+                activeKeys.push_back(key);
+            }
+            else{
+                size_t k = random.Next((uint32_t)activeKeys.size());
+                uint8_t key = activeKeys[k];
+                activeKeys.erase(activeKeys.begin() + k);
+                if(random.Next(100) < probabilityMissingOff){
+                    continue;
+                }
+                bool zeroVelocity = random.Next(2);
+                track.AddEvent(deltaTime, zeroVelocity ? (0x90 | channel) : (0x80 | channel), {key, (uint8_t)(zeroVelocity ? 0 : 64)});
+                if(random.Next(100) < probabilityDuplicate){
+                    track.AddEvent(random.Next(60), 0x80 | channel, {key, 64});
+                }
+            }
+        }
+        track.AddEvent(0, 0xFF, {0x2F, 0x00});
+    }
+    std::vector<uint8_t> bytes;
+    (void) midi.Write(bytes);
+    return bytes;
+}
+
+
+/**
+ *  @brief Compare the lanes of both implementations for all tracks and channels of a MIDI file.
+ *  @param [in] name Name of the MIDI file to be printed.
+ *  @param [in] midi The MIDI file.
+ *  @return Number of mismatching lanes.
+ */
+static uint32_t CompareLanes(std::string name, const MIDIFile& midi){
+    // Tempo map like Sequencer::ReadMIDIFile
+    std::map<uint64_t, double> tempoChanges;
+    for(auto&& track : midi.tracks){
+        for(auto&& event : track.events){
+            const uint8_t* data = track.GetData(event);
+            if((0xFF == event.status) && (5 == event.dataLength) && (0x51 == data[0]) && (0x03 == data[1])){
+                uint32_t usPerQuarter = (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 8) | uint32_t(data[4]);
+                tempoChanges.insert({event.absoluteTicks, 1e-6 * double(usPerQuarter)});
+            }
+        }
+    }
+    tempoChanges.insert({0, 0.5});
+    TempoMap tempoMap;
+    tempoMap.Set(std::vector<std::pair<uint64_t, double>>(tempoChanges.begin(), tempoChanges.end()), midi.header.division);
+
+    // Compare the lanes of all channels of all tracks for two time scales
+    uint32_t numMismatches = 0;
+    uint64_t numBlocks = 0;
+    for(size_t n = (0 == midi.header.format) ? 0 : 1; n < midi.tracks.size(); n++){
+        for(uint8_t channel = 0; channel < 16; channel++){
+            ReferenceTrack track;
+            if(!track.Load(midi, n, channel)){
+                continue;
+            }
+            for(double timeScale : {1.0, 0.75}){
+                ReferenceTrack reference = track;
+                reference.GenerateReferenceLanes(tempoMap, timeScale);
+                (void) track.GenerateLanes(tempoMap, timeScale);
+                for(int k = 0; k < 88; k++){
+                    bool equal = (track.lanes[k].size() == reference.lanes[k].size());
+                    for(size_t i = 0; equal && (i < track.lanes[k].size()); i++){
+                        const NoteBlock& a = track.lanes[k][i];
+                        const NoteBlock& b = reference.lanes[k][i];
+                        equal = (a.on == b.on) && (a.off == b.off) && (a.sustainOff == b.sustainOff) && (a.velocity == b.velocity);
+                    }
+                    if(!equal){
+                        fprintf(stderr, "%s: lane %d of track %zu channel %u differs (time scale %g)\n", name.c_str(), k, n, channel, timeScale);
+                        numMismatches++;
+                    }
+                    numBlocks += track.lanes[k].size();
+                }
+            }
+        }
+    }
+    printf("%s: %llu note blocks compared, %u mismatching lanes\n", name.c_str(), (unsigned long long)numBlocks, numMismatches);
+    return numMismatches;
+}
+
+
+int main(int argc, char** argv){
+    uint32_t numMismatches = 0;
+
+    // Generated corpus: regular, missing note offs, duplicated events, sustain pedal and everything combined
+    const struct { const char* name; uint32_t missingOff; uint32_t duplicate; bool pedal; } corpus[] = {
+        {"regular", 0, 0, false},
+        {"missing-note-off", 30, 0, false},
+        {"duplicated-events", 0, 30, false},
+        {"sustain-pedal", 0, 0, true},
+        {"combined", 20, 20, true}
+    };
+    uint32_t seed = 1;
+    for(auto&& c : corpus){
+        std::vector<uint8_t> bytes = GenerateMIDIFile(seed++, 3, 20000, c.missingOff, c.duplicate, c.pedal);
+        MIDIFile midi;
+        if(!midi.Read(bytes)){
+            fprintf(stderr, "%s: could not read generated MIDI file\n", c.name);
+            return 1;
+        }
+        numMismatches += CompareLanes(c.name, midi);
+    }
+
+    // Additional MIDI files
+    for(int i = 1; i < argc; i++){
+        MIDIFile midi;
+        if(!midi.Read(std::string(argv[i]))){
+            fprintf(stderr, "%s: could not read MIDI file\n", argv[i]);
+            return 1;
+        }
+        numMismatches += CompareLanes(argv[i], midi);
+    }
+    printf(numMismatches ? "FAILED\n" : "PASSED\n");
+    return numMismatches ? 1 : 0;
+}
+